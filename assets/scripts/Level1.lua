@@ -90,6 +90,23 @@ Level = {
         { type = "font", id = "pico8-font-10", file = "./assets/fonts/pico8.ttf", font_size = 10 }
     },
 
+    ----------------------------------------------------
+    -- table with the expected number of entities and components
+    -- (tiles and projectiles included), the engine reserves room
+    -- for them when the level is loaded
+    ----------------------------------------------------
+    expected_counts = {
+        entities = 800,
+        transform = 800,
+        rigidbody = 200,
+        sprite = 800,
+        animation = 20,
+        boxcollider = 250,
+        health = 60,
+        projectile_emitter = 40,
+        projectile = 200
+    },
+
     ----------------------------------------------------
     -- table to define the map config variables
     ----------------------------------------------------
@@ -102,6 +119,25 @@ Level = {
         scale = 2.0
     },
 
+    ----------------------------------------------------
+    -- table to define the collision settings, cell_size is the
+    -- size in pixels of the cells of the broadphase grid and
+    -- layers lists the layers each collider layer collides
+    -- with (pairs of layers that are not listed are never
+    -- tested, colliders without a layer are in "default").
+    -- Contacts emit an enter and an exit event, the layers
+    -- listed in stay_layers also emit a stay event every
+    -- frame the contact lasts
+    ----------------------------------------------------
+    collision = {
+        cell_size = 128,
+        layers = {
+            player = { "enemy_projectiles" },
+            enemies = { "player_projectiles", "obstacles" }
+        },
+        stay_layers = {}
+    },
+
     ----------------------------------------------------
     -- table to define entities and their components
     ----------------------------------------------------
@@ -132,6 +168,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "player",
                     width = 32,
                     height = 25,
                     offset = { x = 0, y = 5 }
@@ -259,6 +296,7 @@ Level = {
                     z_index = 2
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 18,
                     offset = { x = 0, y = 7 }
@@ -291,6 +329,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 18,
                     offset = { x = 7, y = 10 }
@@ -323,6 +362,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 20,
                     height = 18,
                     offset = { x = 5, y = 7 }
@@ -355,6 +395,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 18,
                     offset = { x = 5, y = 7 }
@@ -387,6 +428,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 18,
                     offset = { x = 5, y = 7 }
@@ -419,6 +461,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 18,
                     offset = { x = 5, y = 7 }
@@ -451,6 +494,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 18,
                     offset = { x = 5, y = 7 }
@@ -483,6 +527,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 18,
                     offset = { x = 8, y = 6 }
@@ -515,6 +560,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 18,
                     offset = { x = 8, y = 6 }
@@ -564,6 +610,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 20,
                     height = 17,
                     offset = { x = 7, y = 7 }
@@ -596,6 +643,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 18,
                     height = 20,
                     offset = { x = 7, y = 7 }
@@ -628,6 +676,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 18,
                     offset = { x = 7, y = 7 }
@@ -660,6 +709,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 18,
                     offset = { x = 0, y = 7 }
@@ -692,6 +742,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 20,
                     offset = { x = 8, y = 4 }
@@ -724,6 +775,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 20,
                     offset = { x = 7, y = 8 }
@@ -756,6 +808,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 20,
                     offset = { x = 7, y = 8 }
@@ -788,6 +841,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 20,
                     offset = { x = 7, y = 8 }
@@ -820,6 +874,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 20,
                     offset = { x = 7, y = 8 }
@@ -852,6 +907,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 20,
                     offset = { x = 7, y = 8 }
@@ -884,6 +940,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 22,
                     height = 18,
                     offset = { x = 5, y = 7 }
@@ -916,6 +973,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 18,
                     offset = { x = 7, y = 7 }
@@ -948,6 +1006,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 19,
                     height = 20,
                     offset = { x = 6, y = 7 }
@@ -980,6 +1039,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 18,
                     height = 25,
                     offset = { x = 7, y = 7 }
@@ -1012,6 +1072,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 20,
                     offset = { x = 8, y = 4 }
@@ -1061,6 +1122,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 25,
                     offset = { x = 10, y = 2 }
@@ -1086,6 +1148,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 25,
                     offset = { x = 10, y = 2 }
@@ -1111,6 +1174,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 25,
                     offset = { x = 10, y = 2 }
@@ -1136,6 +1200,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 25,
                     offset = { x = 10, y = 2 }
@@ -1161,6 +1226,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 25,
                     offset = { x = 10, y = 2 }
@@ -1186,6 +1252,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 25,
                     offset = { x = 10, y = 2 }
@@ -1211,6 +1278,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 20,
                     offset = { x = 10, y = 8 }
@@ -1236,6 +1304,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 20,
                     offset = { x = 10, y = 8 }
@@ -1261,6 +1330,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 20,
                     offset = { x = 10, y = 8 }
@@ -1286,6 +1356,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 16,
                     offset = { x = 3, y = 10 }
@@ -1311,6 +1382,7 @@ Level = {
                     z_index = 2
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 16,
                     offset = { x = 3, y = 10 }
@@ -1340,6 +1412,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1376,6 +1449,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1412,6 +1486,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1448,6 +1523,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1480,6 +1556,7 @@ Level = {
                     z_index = 2
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1512,6 +1589,7 @@ Level = {
                     z_index = 2
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1544,6 +1622,7 @@ Level = {
                     z_index = 2
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1576,6 +1655,7 @@ Level = {
                     z_index = 2
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1608,6 +1688,7 @@ Level = {
                     z_index = 2
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -1640,6 +1721,7 @@ Level = {
                     z_index = 2
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -2588,6 +2670,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 20,
                     height = 25,
                     offset = { x = 5, y = 5 }
@@ -2620,6 +2703,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2649,6 +2733,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 32,
                     height = 32,
                     offset = { x = 0, y = 0 }
@@ -2681,6 +2766,7 @@ Level = {
                     speed_rate = 15 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 32,
                     height = 30,
                     offset = { x = 0, y = 0 }
@@ -2777,6 +2863,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 32,
                     height = 32
                 },
@@ -2840,6 +2927,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 32,
                     height = 32
                 },
@@ -78,6 +78,23 @@ Level = {
         { type = "font"   , id = "pico8-font-10",               file = "./assets/fonts/pico8.ttf", font_size = 10 }
     },
 
+    ----------------------------------------------------
+    -- table with the expected number of entities and components
+    -- (tiles and projectiles included), the engine reserves room
+    -- for them when the level is loaded
+    ----------------------------------------------------
+    expected_counts = {
+        entities = 1500,
+        transform = 1500,
+        rigidbody = 200,
+        sprite = 1500,
+        animation = 25,
+        boxcollider = 250,
+        health = 50,
+        projectile_emitter = 40,
+        projectile = 200
+    },
+
     ----------------------------------------------------
     -- table to define the map config variables
     ----------------------------------------------------
@@ -90,6 +107,25 @@ Level = {
         scale = 2.0
     },
 
+    ----------------------------------------------------
+    -- table to define the collision settings, cell_size is the
+    -- size in pixels of the cells of the broadphase grid and
+    -- layers lists the layers each collider layer collides
+    -- with (pairs of layers that are not listed are never
+    -- tested, colliders without a layer are in "default").
+    -- Contacts emit an enter and an exit event, the layers
+    -- listed in stay_layers also emit a stay event every
+    -- frame the contact lasts
+    ----------------------------------------------------
+    collision = {
+        cell_size = 128,
+        layers = {
+            player = { "enemy_projectiles" },
+            enemies = { "player_projectiles", "obstacles" }
+        },
+        stay_layers = {}
+    },
+
     ----------------------------------------------------
     -- table to define entities and their components
     ----------------------------------------------------
@@ -117,6 +153,7 @@ Level = {
                     src_rect_y = 0
                 },
                 boxcollider = {
+                    layer = "player",
                     width = 32,
                     height = 25,
                     offset = { x = 0, y = 5 }
@@ -344,6 +381,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -380,6 +418,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -416,6 +455,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -452,6 +492,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -488,6 +529,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -524,6 +566,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -560,6 +603,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -597,6 +641,7 @@ Level = {
                     speed_rate = 2 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 17,
                     height = 15,
                     offset = { x = 8, y = 8 }
@@ -629,6 +674,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -661,6 +707,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -693,6 +740,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -725,6 +773,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -757,6 +806,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -789,6 +839,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -821,6 +872,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -853,6 +905,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -885,6 +938,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -917,6 +971,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 20,
                     offset = { x = 10, y = 8 }
@@ -949,6 +1004,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 20,
                     offset = { x = 10, y = 8 }
@@ -981,6 +1037,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 20,
                     offset = { x = 10, y = 8 }
@@ -1013,6 +1070,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 12,
                     height = 20,
                     offset = { x = 10, y = 8 }
@@ -1045,6 +1103,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -1077,6 +1136,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -1109,6 +1169,7 @@ Level = {
                     z_index = 1
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 30,
                     height = 20,
                     offset = { x = 0, y = 5 }
@@ -2233,6 +2294,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2265,6 +2327,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2297,6 +2360,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2329,6 +2393,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2361,6 +2426,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2390,6 +2456,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 20,
                     height = 25,
                     offset = { x = 5, y = 5}
@@ -2419,6 +2486,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 32,
                     height = 32,
                     offset = { x = 0, y = 0 }
@@ -2451,6 +2519,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2483,6 +2552,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2515,6 +2585,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 32,
                     height = 32
                 },
@@ -2568,6 +2639,7 @@ Level = {
                     speed_rate = 10 -- fps
                 },
                 boxcollider = {
+                    layer = "enemies",
                     width = 32,
                     height = 24
                 },
@@ -0,0 +1,98 @@
+// Microbenchmark of the collision narrowphase: PackedBoxes::Overlap (AVX2/SSE2) against the scalar tests
+// Build with cmake -DEON_BUILD_BENCHMARKS=ON (add -DEON_ENABLE_AVX2=ON for the 8-wide path) or make bench
+// Usage: collision_benchmark [number of boxes] [iterations]
+
+#include "../src/SpatialHash/SpatialHash.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/// @brief Runs a function several times and returns the mean time of one run in microseconds
+template<typename TFunction>
+static double MeasureMicroseconds(int iterations, TFunction function) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        function();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int main(int argc, char *argv[]) {
+    const int numBoxes = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    // Boxes of the size of the level sprites spread over a 4096x4096 map, in 4 layers where each layer collides
+    // with itself and the next one
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(0.0f, 4096.0f);
+    std::uniform_real_distribution<float> size(8.0f, 64.0f);
+    std::vector<AABB> boxes(numBoxes);
+    std::vector<CollisionFilter> filters(numBoxes);
+    for (int box = 0; box < numBoxes; box++) {
+        const float x = position(random);
+        const float y = position(random);
+        boxes[box] = AABB{x, y, x + size(random), y + size(random)};
+        const int layer = static_cast<int>(random() % 4);
+        filters[box] = CollisionFilter{1u << layer, (1u << layer) | (1u << ((layer + 1) % 4)) | (1u << ((layer + 3) % 4))};
+    }
+
+    PackedBoxes packedBoxes;
+    packedBoxes.Reserve(numBoxes + PackedBoxes::LANES);
+    for (int box = 0; box < numBoxes; box++) {
+        packedBoxes.Add(boxes[box], filters[box]);
+    }
+    packedBoxes.AlignToBlock();
+    std::vector<int> hits(packedBoxes.GetSize());
+
+    // Narrowphase: every box against every box, the worst case of a cell
+    long long scalarHits = 0;
+    const double scalarTime = MeasureMicroseconds(iterations, [&]() {
+        scalarHits = 0;
+        for (int a = 0; a < numBoxes; a++) {
+            for (int b = 0; b < numBoxes; b++) {
+                if (SpatialHash::Interacts(filters[a], filters[b]) && SpatialHash::Overlaps(boxes[a], boxes[b])) {
+                    hits[scalarHits++ % hits.size()] = b;
+                }
+            }
+        }
+    });
+
+    long long packedScalarHits = 0;
+    const double packedScalarTime = MeasureMicroseconds(iterations, [&]() {
+        packedScalarHits = 0;
+        for (int a = 0; a < numBoxes; a++) {
+            packedScalarHits += packedBoxes.OverlapScalar(boxes[a], filters[a], 0, numBoxes, hits.data());
+        }
+    });
+
+    long long packedHits = 0;
+    const double packedTime = MeasureMicroseconds(iterations, [&]() {
+        packedHits = 0;
+        for (int a = 0; a < numBoxes; a++) {
+            packedHits += packedBoxes.Overlap(boxes[a], filters[a], 0, numBoxes, hits.data());
+        }
+    });
+
+    // Whole broadphase of a frame, as CollisionSystem runs it for the dynamic colliders
+    SpatialHash grid;
+    std::vector<BoxPair> pairs;
+    const double gridTime = MeasureMicroseconds(iterations, [&]() {
+        grid.Build(boxes.data(), numBoxes, filters.data());
+        grid.FindPairs(pairs);
+    });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << numBoxes << " boxes, " << iterations << " iterations, " << PackedBoxes::LANES << " lanes\n";
+    std::cout << "all pairs, AABB scalar:        " << scalarTime << " us (" << scalarHits << " hits)\n";
+    std::cout << "all pairs, PackedBoxes scalar: " << packedScalarTime << " us (" << packedScalarHits << " hits)\n";
+    std::cout << "all pairs, PackedBoxes SIMD:   " << packedTime << " us (" << packedHits << " hits), "
+              << scalarTime / packedTime << "x\n";
+    std::cout << "SpatialHash Build + FindPairs: " << gridTime << " us (" << pairs.size() << " pairs)\n";
+
+    return scalarHits == packedHits && packedScalarHits == packedHits ? 0 : 1;
+}
@@ -3,18 +3,36 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
+
+/// @brief Number of collision layers, a mask has one bit per layer
+const int MAX_COLLISION_LAYERS = 32;
+
+/// @brief Mask of a collider that collides with every layer
+const std::uint32_t ALL_COLLISION_LAYERS = 0xFFFFFFFFu;
+
 struct BoxColliderComponent
 {
     int width;
     int height;
     glm::vec2 offset;
 
-    BoxColliderComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0))
+    /// @brief Collision layer of the collider [0, MAX_COLLISION_LAYERS), see CollisionSystem::GetLayer
+    int layer;
+
+    /// @brief Layers the collider collides with, one bit per layer
+    /// It only narrows the layer interactions of the CollisionSystem, it can not add to them.
+    std::uint32_t mask;
+
+    BoxColliderComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0), int layer = 0,
+                         std::uint32_t mask = ALL_COLLISION_LAYERS)
     {
         this->width = width;
         this->height = height;
         this->offset = offset;
+        this->layer = layer;
+        this->mask = mask;
     }
 };
 
-#endif /// BOXCOLLIDERCOMPONENT_H
\ No newline at end of file
+#endif /// BOXCOLLIDERCOMPONENT_H
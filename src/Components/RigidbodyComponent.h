@@ -1,7 +1,10 @@
 #ifndef RIGIDBODYCOMPONENT_H
 #define RIGIDBODYCOMPONENT_H
 
+#include "../ECS/SoALayout.h"
+
 #include <glm/glm.hpp>
+#include <vector>
 
 struct RigidbodyComponent
 {
@@ -13,4 +16,64 @@ struct RigidbodyComponent
     }
 };
 
-#endif /** RIGIDBODYCOMPONENT_H */
\ No newline at end of file
+/// @brief Rigidbody stored in the vx[] and vy[] arrays of its pool
+struct RigidbodyComponentRef
+{
+    Vec2Ref velocity;
+
+    explicit RigidbodyComponentRef(Vec2Ref velocity) : velocity(velocity)
+    {
+    }
+
+    RigidbodyComponentRef(const RigidbodyComponentRef &) = default;
+
+    RigidbodyComponentRef &operator=(const RigidbodyComponentRef &other)
+    {
+        velocity = other.velocity;
+        return *this;
+    }
+
+    RigidbodyComponentRef &operator=(const RigidbodyComponent &value)
+    {
+        velocity = value.velocity;
+        return *this;
+    }
+
+    operator RigidbodyComponent() const
+    {
+        return RigidbodyComponent(velocity);
+    }
+};
+
+template<>
+struct SoALayout<RigidbodyComponent>
+{
+    static constexpr bool isEnabled = true;
+
+    typedef RigidbodyComponentRef Reference;
+
+    struct Columns
+    {
+        std::vector<float> vx;
+        std::vector<float> vy;
+    };
+
+    template<typename TColumns, typename TFunction>
+    static void ForEachColumn(TColumns &columns, TFunction function)
+    {
+        function(columns.vx);
+        function(columns.vy);
+    }
+
+    static Reference At(Columns &columns, std::size_t index)
+    {
+        return Reference(Vec2Ref(columns.vx[index], columns.vy[index]));
+    }
+
+    static Reference Bind(RigidbodyComponent &rigidbody)
+    {
+        return Reference(Vec2Ref(rigidbody.velocity.x, rigidbody.velocity.y));
+    }
+};
+
+#endif /** RIGIDBODYCOMPONENT_H */
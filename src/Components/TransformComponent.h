@@ -1,13 +1,16 @@
 #ifndef TRANSFORMCOMPONENT_H
 #define TRANSFORMCOMPONENT_H
 
+#include "../ECS/SoALayout.h"
+
 #include <glm/glm.hpp>
+#include <vector>
 
 struct TransformComponent
 {
     glm::vec2 position;
     glm::vec2 scale;
-    double rotation;
+    float rotation;
 
     TransformComponent(
         glm::vec2 position = glm::vec2(0, 0),
@@ -16,8 +19,85 @@ struct TransformComponent
     {
         this->position = position;
         this->scale = scale;
-        this->rotation = rotation;
+        this->rotation = static_cast<float>(rotation);
+    }
+};
+
+/// @brief Transform stored in the x[], y[], scaleX[], scaleY[] and rotation[] arrays of its pool
+/// Reads and writes go straight to the arrays: transform.position.x += dx;
+struct TransformComponentRef
+{
+    Vec2Ref position;
+    Vec2Ref scale;
+    float &rotation;
+
+    TransformComponentRef(Vec2Ref position, Vec2Ref scale, float &rotation)
+        : position(position), scale(scale), rotation(rotation)
+    {
+    }
+
+    TransformComponentRef(const TransformComponentRef &) = default;
+
+    TransformComponentRef &operator=(const TransformComponentRef &other)
+    {
+        return *this = static_cast<TransformComponent>(other);
+    }
+
+    TransformComponentRef &operator=(const TransformComponent &value)
+    {
+        position = value.position;
+        scale = value.scale;
+        rotation = value.rotation;
+        return *this;
+    }
+
+    operator TransformComponent() const
+    {
+        return TransformComponent(position, scale, rotation);
+    }
+};
+
+template<>
+struct SoALayout<TransformComponent>
+{
+    static constexpr bool isEnabled = true;
+
+    typedef TransformComponentRef Reference;
+
+    struct Columns
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> scaleX;
+        std::vector<float> scaleY;
+        std::vector<float> rotation;
+    };
+
+    template<typename TColumns, typename TFunction>
+    static void ForEachColumn(TColumns &columns, TFunction function)
+    {
+        function(columns.x);
+        function(columns.y);
+        function(columns.scaleX);
+        function(columns.scaleY);
+        function(columns.rotation);
+    }
+
+    static Reference At(Columns &columns, std::size_t index)
+    {
+        return Reference(
+            Vec2Ref(columns.x[index], columns.y[index]),
+            Vec2Ref(columns.scaleX[index], columns.scaleY[index]),
+            columns.rotation[index]);
+    }
+
+    static Reference Bind(TransformComponent &transform)
+    {
+        return Reference(
+            Vec2Ref(transform.position.x, transform.position.y),
+            Vec2Ref(transform.scale.x, transform.scale.y),
+            transform.rotation);
     }
 };
 
-#endif /* TRANSFORMCOMPONENT_H */
\ No newline at end of file
+#endif /* TRANSFORMCOMPONENT_H */
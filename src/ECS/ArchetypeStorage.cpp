@@ -0,0 +1,191 @@
+#include "ArchetypeStorage.h"
+
+#include <algorithm>
+
+/// @brief Alignment of the memory of every chunk (one cache line)
+const std::size_t ARCHETYPE_CHUNK_ALIGNMENT = 64;
+
+ArchetypeChunk::ArchetypeChunk(std::size_t size) {
+    bytes = static_cast<unsigned char *>(::operator new(size, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT)));
+}
+
+ArchetypeChunk::~ArchetypeChunk() {
+    ::operator delete(bytes, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+}
+
+/// @brief Rounds a byte offset up to the next multiple of an alignment
+static std::size_t AlignOffset(std::size_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/// @brief Creates the archetype and computes the column layout of its chunks
+/// @param signature Components of the entities stored in the archetype
+/// @param componentTypes Type-erased info of all registered components [vector index = component id]
+/// @details The entity ids column comes first, followed by one column per component. The number of rows
+/// per chunk is the largest one that fits all the (aligned) columns in ARCHETYPE_CHUNK_SIZE bytes.
+Archetype::Archetype(const Signature &signature, const std::vector<ComponentTypeInfo> &componentTypes)
+    : signature(signature) {
+    std::size_t rowSize = sizeof(int);
+    for (std::size_t componentId = 0; componentId < signature.size(); componentId++) {
+        if (signature.test(componentId) && !componentTypes[componentId].isEmpty) {
+            componentIds.push_back(static_cast<int>(componentId));
+            columnStrides.push_back(componentTypes[componentId].size);
+            rowSize += componentTypes[componentId].size;
+        }
+    }
+
+    columnOfComponent.assign(signature.size(), -1);
+    for (std::size_t column = 0; column < componentIds.size(); column++) {
+        columnOfComponent[componentIds[column]] = static_cast<int>(column);
+    }
+
+    chunkCapacity = std::max<int>(1, static_cast<int>(ARCHETYPE_CHUNK_SIZE / rowSize));
+    while (true) {
+        std::size_t offset = chunkCapacity * sizeof(int);
+        columnOffsets.clear();
+        for (std::size_t column = 0; column < componentIds.size(); column++) {
+            offset = AlignOffset(offset, componentTypes[componentIds[column]].alignment);
+            columnOffsets.push_back(offset);
+            offset += chunkCapacity * columnStrides[column];
+        }
+        chunkSize = offset;
+        if (chunkSize <= ARCHETYPE_CHUNK_SIZE || chunkCapacity == 1) {
+            break;
+        }
+        chunkCapacity--;
+    }
+    chunkSize = std::max(chunkSize, ARCHETYPE_CHUNK_SIZE);
+}
+
+ArchetypeStorage::~ArchetypeStorage() {
+    for (auto &archetype: archetypes) {
+        for (int row = 0; row < archetype->count; row++) {
+            for (std::size_t column = 0; column < archetype->componentIds.size(); column++) {
+                componentTypes[archetype->componentIds[column]].destroy(archetype->GetCell(row, column));
+            }
+        }
+    }
+}
+
+void ArchetypeStorage::RegisterComponentType(int componentId, const ComponentTypeInfo &info) {
+    if (static_cast<std::size_t>(componentId) >= componentTypes.size()) {
+        componentTypes.resize(componentId + 1);
+    }
+    componentTypes[componentId] = info;
+}
+
+ArchetypeStorage::EntityLocation &ArchetypeStorage::GetLocation(int entityId) {
+    if (static_cast<std::size_t>(entityId) >= entityLocations.size()) {
+        entityLocations.resize(entityId + 1);
+    }
+    return entityLocations[entityId];
+}
+
+Archetype *ArchetypeStorage::GetOrCreateArchetype(const Signature &signature) {
+    auto archetype = archetypePerSignature.find(signature);
+    if (archetype != archetypePerSignature.end()) {
+        return archetype->second;
+    }
+
+    archetypes.push_back(std::make_unique<Archetype>(signature, componentTypes));
+    archetypePerSignature.emplace(signature, archetypes.back().get());
+    return archetypes.back().get();
+}
+
+/// @brief Moves an entity to another archetype
+/// @param entityId Entity to be moved
+/// @param destination Archetype that will store the entity (nullptr when the entity has no components)
+/// @return Row of the entity in the destination archetype
+/// @details Components present in both archetypes are move-constructed into the new row, components that
+/// only exist in the source archetype are destroyed. Columns that only exist in the destination archetype
+/// are left uninitialized for the caller to construct.
+int ArchetypeStorage::MoveEntity(int entityId, Archetype *destination) {
+    EntityLocation &location = GetLocation(entityId);
+    Archetype *source = location.archetype;
+    int destinationRow = 0;
+
+    if (destination) {
+        destinationRow = destination->count;
+        if (destinationRow == static_cast<int>(destination->chunks.size()) * destination->chunkCapacity) {
+            destination->chunks.push_back(std::make_unique<ArchetypeChunk>(destination->chunkSize));
+        }
+        destination->count++;
+        destination->EntityIdAt(destinationRow) = entityId;
+    }
+
+    if (source) {
+        for (std::size_t column = 0; column < source->componentIds.size(); column++) {
+            const int componentId = source->componentIds[column];
+            void *sourceCell = source->GetCell(location.row, column);
+            if (destination && destination->HasComponent(componentId)) {
+                void *destinationCell = destination->GetCell(destinationRow, destination->columnOfComponent[componentId]);
+                componentTypes[componentId].moveConstruct(destinationCell, sourceCell);
+            }
+            componentTypes[componentId].destroy(sourceCell);
+        }
+        RemoveRow(source, location.row);
+    }
+
+    location.archetype = destination;
+    location.row = destinationRow;
+    return destinationRow;
+}
+
+/// @brief Fills the hole left at a row by moving the last row of the archetype into it
+/// @param archetype Archetype that lost an entity
+/// @param row Row whose components were already destroyed
+void ArchetypeStorage::RemoveRow(Archetype *archetype, int row) {
+    const int lastRow = archetype->count - 1;
+
+    if (row != lastRow) {
+        for (std::size_t column = 0; column < archetype->componentIds.size(); column++) {
+            const auto &componentType = componentTypes[archetype->componentIds[column]];
+            void *lastCell = archetype->GetCell(lastRow, column);
+            componentType.moveConstruct(archetype->GetCell(row, column), lastCell);
+            componentType.destroy(lastCell);
+        }
+        const int movedEntityId = archetype->EntityIdAt(lastRow);
+        archetype->EntityIdAt(row) = movedEntityId;
+        entityLocations[movedEntityId].row = row;
+    }
+
+    archetype->count--;
+
+    // Release the last chunk once it becomes empty
+    if (archetype->count <= (static_cast<int>(archetype->chunks.size()) - 1) * archetype->chunkCapacity) {
+        archetype->chunks.pop_back();
+    }
+}
+
+void *ArchetypeStorage::AddComponent(int entityId, int componentId) {
+    Signature signature = GetLocation(entityId).archetype ? GetLocation(entityId).archetype->signature : Signature();
+    signature.set(componentId);
+
+    Archetype *destination = GetOrCreateArchetype(signature);
+    const int row = MoveEntity(entityId, destination);
+    if (!destination->HasComponent(componentId)) {
+        return nullptr;
+    }
+    return destination->GetCell(row, destination->columnOfComponent[componentId]);
+}
+
+void ArchetypeStorage::AddComponents(int entityId, const Signature &signature) {
+    MoveEntity(entityId, GetOrCreateArchetype(signature));
+}
+
+void ArchetypeStorage::RemoveComponent(int entityId, int componentId) {
+    Archetype *source = GetLocation(entityId).archetype;
+    if (!source || !source->signature.test(componentId)) {
+        return;
+    }
+
+    Signature signature = source->signature;
+    signature.reset(componentId);
+    MoveEntity(entityId, signature.none() ? nullptr : GetOrCreateArchetype(signature));
+}
+
+void ArchetypeStorage::RemoveEntity(int entityId) {
+    if (static_cast<std::size_t>(entityId) < entityLocations.size() && entityLocations[entityId].archetype) {
+        MoveEntity(entityId, nullptr);
+    }
+}
@@ -0,0 +1,205 @@
+#ifndef ARCHETYPESTORAGE_H
+#define ARCHETYPESTORAGE_H
+
+#include "Signature.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/// @brief Size in bytes of each chunk of an archetype
+const std::size_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+
+/// @brief Type-erased operations used to move components between archetype chunks
+struct ComponentTypeInfo {
+    std::size_t size = 0;
+    std::size_t alignment = 0;
+
+    /// @brief Empty (tag) components are part of the archetype signature but have no column
+    bool isEmpty = false;
+
+    /// @brief Move-constructs the object at source into the uninitialized memory at destination
+    void (*moveConstruct)(void *destination, void *source) = nullptr;
+
+    /// @brief Calls the destructor of the object
+    void (*destroy)(void *object) = nullptr;
+};
+
+/// @brief Builds the type-erased operations of a component type
+/// @tparam T Component type
+/// @return Size, alignment, move and destroy operations of T
+template<typename T>
+ComponentTypeInfo MakeComponentTypeInfo() {
+    ComponentTypeInfo info;
+    info.size = sizeof(T);
+    info.alignment = alignof(T);
+    info.isEmpty = std::is_empty<T>::value;
+    info.moveConstruct = [](void *destination, void *source) {
+        new(destination) T(std::move(*static_cast<T *>(source)));
+    };
+    info.destroy = [](void *object) {
+        static_cast<T *>(object)->~T();
+    };
+    return info;
+}
+
+/// @brief Fixed-size block of memory holding a column of entity ids and one column per component
+class ArchetypeChunk {
+private:
+    unsigned char *bytes;
+
+public:
+    explicit ArchetypeChunk(std::size_t size);
+
+    ~ArchetypeChunk();
+
+    ArchetypeChunk(const ArchetypeChunk &) = delete;
+
+    ArchetypeChunk &operator=(const ArchetypeChunk &) = delete;
+
+    unsigned char *GetBytes() const { return bytes; }
+};
+
+/// @brief Group of all entities that have exactly the same component signature
+/// Rows are kept packed across chunks: every chunk is full except the last one.
+class Archetype {
+private:
+    Signature signature;
+    std::vector<int> componentIds;
+
+    /// @brief Column index of each component id, -1 when the archetype does not have the component
+    std::vector<int> columnOfComponent;
+
+    std::vector<std::size_t> columnOffsets;
+    std::vector<std::size_t> columnStrides;
+    std::size_t chunkSize;
+    int chunkCapacity;
+    int count = 0;
+    std::vector<std::unique_ptr<ArchetypeChunk> > chunks;
+
+    friend class ArchetypeStorage;
+
+public:
+    Archetype(const Signature &signature, const std::vector<ComponentTypeInfo> &componentTypes);
+
+    const Signature &GetSignature() const { return signature; }
+
+    /// @brief Gets the number of entities stored in the archetype
+    int GetCount() const { return count; }
+
+    int GetChunkCount() const { return static_cast<int>(chunks.size()); }
+
+    /// @brief Gets the maximum number of entities that fit in one chunk
+    int GetChunkCapacity() const { return chunkCapacity; }
+
+    /// @brief Gets the size in bytes of each chunk
+    std::size_t GetChunkSize() const { return chunkSize; }
+
+    /// @brief Gets the number of entities stored in a chunk
+    int GetChunkCount(int chunkIndex) const {
+        return chunkIndex < GetChunkCount() - 1 ? chunkCapacity : count - chunkIndex * chunkCapacity;
+    }
+
+    /// @brief Gets the entity ids column of a chunk
+    const int *GetEntityIds(int chunkIndex) const {
+        return reinterpret_cast<const int *>(chunks[chunkIndex]->GetBytes());
+    }
+
+    /// @brief Checks if the archetype stores a column for a component (empty components have none)
+    bool HasComponent(int componentId) const {
+        return static_cast<std::size_t>(componentId) < columnOfComponent.size() && columnOfComponent[componentId] >= 0;
+    }
+
+    /// @brief Gets the start of the column of a component inside a chunk
+    /// @param chunkIndex Chunk to read
+    /// @param componentId Component type id (must be stored by the archetype)
+    /// @return Pointer to the first component of the column
+    void *GetColumn(int chunkIndex, int componentId) const {
+        return chunks[chunkIndex]->GetBytes() + columnOffsets[columnOfComponent[componentId]];
+    }
+
+    /// @brief Gets the memory of a component at a row of the archetype
+    void *GetCell(int row, int column) const {
+        return chunks[row / chunkCapacity]->GetBytes() + columnOffsets[column] +
+               (row % chunkCapacity) * columnStrides[column];
+    }
+
+    int &EntityIdAt(int row) const {
+        return reinterpret_cast<int *>(chunks[row / chunkCapacity]->GetBytes())[row % chunkCapacity];
+    }
+};
+
+/// @brief Archetype/chunk based component storage
+/// Entities that share a signature live together in fixed-size chunks with one column per component, so
+/// iterating a set of components is a linear walk over the chunks of the matching archetypes. Adding or
+/// removing a component moves the entity to the archetype of its new signature.
+class ArchetypeStorage {
+private:
+    /// @brief Location of an entity inside the storage
+    struct EntityLocation {
+        Archetype *archetype = nullptr;
+        int row = 0;
+    };
+
+    std::vector<ComponentTypeInfo> componentTypes;
+    std::vector<std::unique_ptr<Archetype> > archetypes;
+    std::unordered_map<Signature, Archetype *> archetypePerSignature;
+
+    // [Vector index = entity id]
+    std::vector<EntityLocation> entityLocations;
+
+    Archetype *GetOrCreateArchetype(const Signature &signature);
+
+    /// @brief Moves an entity (and the components both archetypes share) to another archetype
+    /// @return Row of the entity in the destination archetype
+    int MoveEntity(int entityId, Archetype *destination);
+
+    /// @brief Fills the hole left at a row by moving the last row of the archetype into it
+    void RemoveRow(Archetype *archetype, int row);
+
+    EntityLocation &GetLocation(int entityId);
+
+public:
+    ArchetypeStorage() = default;
+
+    ~ArchetypeStorage();
+
+    ArchetypeStorage(const ArchetypeStorage &) = delete;
+
+    ArchetypeStorage &operator=(const ArchetypeStorage &) = delete;
+
+    /// @brief Registers the type-erased operations of a component type (done once per type)
+    void RegisterComponentType(int componentId, const ComponentTypeInfo &info);
+
+    bool IsComponentTypeRegistered(int componentId) const {
+        return static_cast<std::size_t>(componentId) < componentTypes.size() && componentTypes[componentId].size > 0;
+    }
+
+    /// @brief Moves the entity to the archetype that also has the component
+    /// @return Uninitialized memory where the caller must construct the new component, nullptr for empty components
+    void *AddComponent(int entityId, int componentId);
+
+    /// @brief Moves the entity to the archetype of a signature that contains its current one, in a single move
+    /// @details The columns of the new components are left uninitialized, the caller must construct them
+    void AddComponents(int entityId, const Signature &signature);
+
+    /// @brief Destroys a component and moves the entity to the archetype without it
+    void RemoveComponent(int entityId, int componentId);
+
+    /// @brief Destroys all the components of an entity
+    void RemoveEntity(int entityId);
+
+    /// @brief Gets a component of an entity (the entity must have it)
+    void *Get(int entityId, int componentId) const {
+        const EntityLocation &location = entityLocations[entityId];
+        return location.archetype->GetCell(location.row, location.archetype->columnOfComponent[componentId]);
+    }
+
+    /// @brief Gets all archetypes created so far
+    const std::vector<std::unique_ptr<Archetype> > &GetArchetypes() const { return archetypes; }
+};
+
+#endif /** ARCHETYPESTORAGE_H */
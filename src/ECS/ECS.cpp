@@ -2,15 +2,47 @@
 #include "../Logger/Logger.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
 
 /// @brief Initialize the static component ID counter
 int IComponent::nextId = 0;
 
-/// @brief Gets the unique identifier of this entity
-/// @return The entity's ID
-/// @details Simple getter that provides access to the private id field
-int Entity::GetId() const {
-    return id;
+int IComponent::NewId() {
+    // An id past the signature bits would make every signature write out of bounds
+    if (static_cast<unsigned int>(nextId) >= MAX_COMPONENTS) {
+        Logger::Err("Too many component types, build with a larger ECS_MAX_COMPONENTS (current " +
+                    std::to_string(MAX_COMPONENTS) + ")");
+        std::abort();
+    }
+    return nextId++;
+}
+
+std::string GetTypeName(const char *mangledName) {
+#if defined(__GNUG__)
+    int status = 0;
+    char *demangledName = abi::__cxa_demangle(mangledName, nullptr, nullptr, &status);
+    if (status == 0 && demangledName) {
+        std::string name(demangledName);
+        std::free(demangledName);
+        return name;
+    }
+#endif
+    return mangledName;
+}
+
+/// @brief Registry shared by all entity handles
+Registry *Entity::registry = nullptr;
+
+/// @brief Checks if this handle still refers to a live entity
+/// @return true if the generation of the handle matches the current generation of its index
+bool Entity::IsAlive() const {
+    return registry->IsEntityAlive(*this);
 }
 
 void Entity::Kill() {
@@ -21,44 +53,75 @@ void Entity::Tag(const std::string &tag) {
     registry->TagEntity(*this, tag);
 }
 
+void Entity::Tag(TagId tag) {
+    registry->TagEntity(*this, tag);
+}
+
 bool Entity::HasTag(const std::string &tag) const {
     return registry->EntityHasTag(*this, tag);
 }
 
+bool Entity::HasTag(TagId tag) const {
+    return registry->EntityHasTag(*this, tag);
+}
+
 void Entity::Group(const std::string &group) {
     registry->GroupEntity(*this, group);
 }
 
+void Entity::Group(GroupId group) {
+    registry->GroupEntity(*this, group);
+}
+
 bool Entity::BelongsToGroup(const std::string &group) const {
     return registry->EntityBelongsToGroup(*this, group);
 }
 
+bool Entity::BelongsToGroup(GroupId group) const {
+    return registry->EntityBelongsToGroup(*this, group);
+}
+
 /// @brief Adds an entity to this system's processing list
 /// @param entity Pointer to the entity to be added
-/// @details Adds the entity to the vector of entities this system processes.
+/// @details Adds the entity to the vector of entities this system processes and records its position.
 /// The entity should already have been verified to have the required components.
 void System::AddEntityToSystem(Entity entity) {
+    const auto entityId = static_cast<std::size_t>(entity.GetId());
+    if (entityId >= entityIndices.size()) {
+        entityIndices.resize(entityId + 1, -1);
+    }
+    if (entityIndices[entityId] >= 0) {
+        return;
+    }
+
+    entityIndices[entityId] = static_cast<int>(entities.size());
     entities.push_back(entity);
 }
 
 /// @brief Removes an entity from this system's processing list
 /// @param entity Pointer to the entity to be removed
-/// @details Uses the erase-remove idiom to efficiently remove the entity from
-/// the vector. The lambda comparison ensures we remove the correct entity by ID.
+/// @details O(1) swap-and-pop: the last entity of the vector is moved into the slot of the removed one,
+/// so the processing order of the remaining entities may change.
 void System::RemoveEntityFromSystem(Entity entity) {
-    entities.erase(
-        std::remove_if(
-            entities.begin(),
-            entities.end(),
-            [&entity](Entity other) { return entity == other; }),
-        entities.end());
+    if (!HasEntity(entity)) {
+        return;
+    }
+
+    const int indexOfRemoved = entityIndices[entity.GetId()];
+    const Entity lastEntity = entities.back();
+    entities[indexOfRemoved] = lastEntity;
+    entityIndices[lastEntity.GetId()] = indexOfRemoved;
+
+    entities.pop_back();
+    entityIndices[entity.GetId()] = -1;
 }
 
 /// @brief Gets all entities currently being processed by this system
-/// @return Vector containing all entities in this system
-/// @details Returns a copy of the entities vector to prevent external modification
-std::vector<Entity> System::GetSystemEntities() const {
-    return entities;
+/// @return View over all entities in this system
+/// @details Does not copy or allocate. The view is read-only and system membership only changes
+/// inside Registry::Update, so it is safe to keep iterating it while entities are killed or created.
+EntityView System::GetSystemEntities() const {
+    return EntityView(entities.data(), entities.data() + entities.size());
 }
 
 /// @brief Gets this system's component requirements
@@ -69,6 +132,17 @@ const Signature &System::GetComponentSignature() const {
     return componentSignature;
 }
 
+/// @brief Checks if the updates of two systems can not run at the same time
+/// @details Two systems conflict when one of them is exclusive, or one writes a component the other reads or
+/// writes. Reading the same component from both systems is allowed.
+bool System::ConflictsWith(const System &other) const {
+    if (IsExclusive() || other.IsExclusive()) {
+        return true;
+    }
+    return componentWrites.Intersects(other.componentReads | other.componentWrites) ||
+           other.componentWrites.Intersects(componentReads);
+}
+
 /// @brief Creates a new entity in the ECS
 /// @return The newly created entity
 /// @details
@@ -78,35 +152,271 @@ const Signature &System::GetComponentSignature() const {
 /// - Logs the creation for debugging
 /// - Returns the new entity to the caller
 Entity Registry::CreateEntity() {
-    long unsigned int entityId;
+    CommandBuffer *commandBuffer = GetCommandBuffer();
+    if (!commandBuffer) {
+        Entity entity = AllocateEntity();
+        if (entity.GetId() != static_cast<int>(MAX_ENTITIES)) {
+            Logger::Log("Entity created with id = " + std::to_string(entity.GetId()));
+        }
+        return entity;
+    }
 
+    // Only reserve the id inside jobs, other threads may be reading the vectors
+    std::lock_guard<std::mutex> lock(entityCreationMutex);
+
+    Entity entity;
     if (freeIds.empty()) {
         // If there are no free ids waiting to be reused
+        if (static_cast<std::uint32_t>(numEntities) >= MAX_ENTITIES) {
+            Logger::Err("Unable to create entity, the maximum of " + std::to_string(MAX_ENTITIES) + " entities was reached");
+            return Entity();
+        }
+        entity = Entity(numEntities++, 0);
+    } else {
+        // Reuse an id from the list of previously removed entities (its generation was bumped when killed)
+        const int entityId = freeIds.front();
+        freeIds.pop_front();
+        entity = Entity(entityId, entityGenerations[entityId]);
+    }
+
+    commandBuffer->entitiesToBeCreated.push_back(entity);
+    return entity;
+}
+
+Entity Registry::AllocateEntity() {
+    int entityId;
+
+    if (freeIds.empty()) {
+        // If there are no free ids waiting to be reused
+        if (static_cast<std::uint32_t>(numEntities) >= MAX_ENTITIES) {
+            Logger::Err("Unable to create entity, the maximum of " + std::to_string(MAX_ENTITIES) + " entities was reached");
+            return Entity();
+        }
         entityId = numEntities++;
 
         // Make sure the entityComponentSignature vector can accommodate the new entity
-        if (entityId >= entityComponentSignatures.size()) {
-            entityComponentSignatures.resize(entityId + 1);
-        }
+        GrowEntityStorage(entityId);
     } else {
-        // Reuse an id from the list of previously removed entities
+        // Reuse an id from the list of previously removed entities (its generation was bumped when killed)
         entityId = freeIds.front();
         freeIds.pop_front();
     }
 
-    Entity entity(entityId);
+    Entity entity(entityId, entityGenerations[entityId]);
+    MarkEntityForRematch(entity);
+    return entity;
+}
 
-    entity.registry = this;
+std::vector<Entity> Registry::CreateEntities(int count) {
+    std::vector<Entity> entities;
+    if (count <= 0) {
+        return entities;
+    }
+    entities.reserve(count);
 
-    entitiesToBeAdd.insert(entity);
+    // Jobs only reserve the ids
+    if (GetCommandBuffer()) {
+        for (int i = 0; i < count; i++) {
+            entities.push_back(CreateEntity());
+        }
+        return entities;
+    }
 
-    Logger::Log("Entity created with id = " + std::to_string(entityId));
+    // Grow the per-entity vectors once for the ids that can not be reused
+    const int numNewIds = count - static_cast<int>(freeIds.size());
+    if (numNewIds > 0) {
+        const int lastEntityId = std::min(numEntities + numNewIds, static_cast<int>(MAX_ENTITIES)) - 1;
+        GrowEntityStorage(lastEntityId);
+    }
+    entitiesToBeRematched.reserve(entitiesToBeRematched.size() + count);
 
-    return entity;
+    for (int i = 0; i < count; i++) {
+        Entity entity = AllocateEntity();
+        if (entity.GetId() == static_cast<int>(MAX_ENTITIES)) {
+            break;
+        }
+        entities.push_back(entity);
+    }
+
+    Logger::Log("Created " + std::to_string(entities.size()) + " entities");
+
+    return entities;
+}
+
+std::vector<Entity> Registry::Instantiate(const Prefab &prefab, int count) {
+    std::vector<Entity> entities;
+    if (count <= 0) {
+        return entities;
+    }
+    entities.reserve(count);
+
+    // Jobs can not touch the storage, record the copies one by one
+    if (GetCommandBuffer()) {
+        for (int i = 0; i < count; i++) {
+            Entity entity = CreateEntity();
+            for (const auto &component: prefab.components) {
+                component.second->AddTo(entity);
+            }
+            for (GroupId group = 0; group < static_cast<GroupId>(MAX_GROUPS); group++) {
+                if ((prefab.groups >> group) & 1u) {
+                    GroupEntity(entity, group);
+                }
+            }
+            entities.push_back(entity);
+        }
+        return entities;
+    }
+
+    for (const auto &component: prefab.components) {
+        component.second->Reserve(*this, count);
+    }
+
+    entities = CreateEntities(count);
+    for (const auto &entity: entities) {
+        const int entityId = entity.GetId();
+
+        // The entity is new, so it gets the whole signature (and its archetype) at once
+        entityComponentSignatures[entityId] = prefab.signature;
+        if (storageMode == StorageMode::Archetypes && prefab.signature.any()) {
+            archetypeStorage->AddComponents(entityId, prefab.signature);
+        }
+        for (const auto &component: prefab.components) {
+            component.second->Construct(*this, entityId);
+        }
+        groupsPerEntity[entityId] = prefab.groups;
+    }
+
+    Logger::Log("Instantiated " + std::to_string(entities.size()) + " entities from a prefab");
+
+    return entities;
+}
+
+Prefab &Registry::CreatePrefab(const std::string &name) {
+    Prefab &prefab = prefabs[name];
+    prefab = Prefab();
+    return prefab;
+}
+
+const Prefab *Registry::GetPrefab(const std::string &name) const {
+    auto prefab = prefabs.find(name);
+    return prefab != prefabs.end() ? &prefab->second : nullptr;
+}
+
+RegistryStats Registry::GetStats() const {
+    RegistryStats stats;
+    stats.numEntities = numEntities;
+    stats.numFreeIds = static_cast<int>(freeIds.size());
+
+    // Ids reserved by jobs are only alive once their command buffer is played back: new ids have no
+    // generation yet and reused ids are neither free nor alive until then
+    int numStoredEntities = static_cast<int>(entityGenerations.size());
+    for (const auto &commandBuffer: commandBuffers) {
+        for (auto entity: commandBuffer.entitiesToBeCreated) {
+            if (static_cast<std::size_t>(entity.GetId()) < entityGenerations.size()) {
+                numStoredEntities--;
+            }
+        }
+    }
+    stats.numLiveEntities = numStoredEntities - stats.numFreeIds;
+
+    for (const auto &pool: componentPools) {
+        if (pool) {
+            stats.pools.push_back(pool->GetStats());
+        }
+    }
+
+    for (const auto &system: systems) {
+        stats.systems.push_back(SystemStats{GetTypeName(system.first.name()),
+                                            static_cast<int>(system.second->GetSystemEntities().size())});
+    }
+    std::sort(stats.systems.begin(), stats.systems.end(),
+              [](const SystemStats &a, const SystemStats &b) { return a.systemName < b.systemName; });
+
+    if (archetypeStorage) {
+        for (const auto &archetype: archetypeStorage->GetArchetypes()) {
+            stats.numArchetypes++;
+            stats.numChunks += archetype->GetChunkCount();
+            stats.chunkBytes += archetype->GetChunkCount() * archetype->GetChunkSize();
+        }
+    }
+
+    return stats;
+}
+
+/// @brief Quotes a string for JSON
+static std::string ToJsonString(const std::string &text) {
+    std::string quoted = "\"";
+    for (char character: text) {
+        if (character == '"' || character == '\\') {
+            quoted += '\\';
+        }
+        quoted += character;
+    }
+    return quoted + "\"";
+}
+
+bool Registry::DumpStatsToJson(const std::string &filePath) const {
+    const RegistryStats stats = GetStats();
+
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"storageMode\": " << (storageMode == StorageMode::Archetypes ? "\"archetypes\"" : "\"pools\"") << ",\n";
+    json << "  \"numEntities\": " << stats.numEntities << ",\n";
+    json << "  \"numLiveEntities\": " << stats.numLiveEntities << ",\n";
+    json << "  \"numFreeIds\": " << stats.numFreeIds << ",\n";
+    json << "  \"numArchetypes\": " << stats.numArchetypes << ",\n";
+    json << "  \"numChunks\": " << stats.numChunks << ",\n";
+    json << "  \"chunkBytes\": " << stats.chunkBytes << ",\n";
+
+    json << "  \"pools\": [";
+    for (std::size_t i = 0; i < stats.pools.size(); i++) {
+        const PoolStats &pool = stats.pools[i];
+        json << (i == 0 ? "\n" : ",\n");
+        json << "    {\"componentId\": " << pool.componentId
+             << ", \"component\": " << ToJsonString(pool.componentName)
+             << ", \"size\": " << pool.size
+             << ", \"peakSize\": " << pool.peakSize
+             << ", \"capacity\": " << pool.capacity
+             << ", \"bytesUsed\": " << pool.bytesUsed
+             << ", \"bytesReserved\": " << pool.bytesReserved
+             << ", \"numGrowths\": " << pool.numGrowths
+             << ", \"fragmentation\": " << pool.fragmentation << "}";
+    }
+    json << (stats.pools.empty() ? "],\n" : "\n  ],\n");
+
+    json << "  \"systems\": [";
+    for (std::size_t i = 0; i < stats.systems.size(); i++) {
+        json << (i == 0 ? "\n" : ",\n");
+        json << "    {\"system\": " << ToJsonString(stats.systems[i].systemName)
+             << ", \"numEntities\": " << stats.systems[i].numEntities << "}";
+    }
+    json << (stats.systems.empty() ? "]\n" : "\n  ]\n");
+    json << "}\n";
+
+    std::ofstream file(filePath);
+    file << json.str();
+    if (!file) {
+        Logger::Err("Unable to write the registry stats to " + filePath);
+        return false;
+    }
+
+    Logger::Log("Registry stats written to " + filePath);
+    return true;
 }
 
+/// @brief Schedules an entity to be killed in the next Update
+/// @param entity Entity to be killed
+/// @details Stale handles (entities already killed, possibly with their index recycled) are ignored
 void Registry::KillEntity(Entity entity) {
-    entitiesToBeKilled.insert(entity);
+    // Entities created by a job are not alive until the playback, so the kill is validated there
+    if (CommandBuffer *commandBuffer = GetCommandBuffer()) {
+        commandBuffer->entitiesToBeKilled.push_back(entity);
+        return;
+    }
+
+    if (IsEntityAlive(entity)) {
+        entitiesToBeKilled.push_back(entity);
+    }
 }
 
 /// @brief Updates which systems should process an entity
@@ -122,12 +432,13 @@ void Registry::AddEntityToSystems(Entity entity) {
     const auto entityId = entity.GetId();
 
     const auto &entityComponentSignature = entityComponentSignatures[entityId];
+    entitySystemSignatures[entityId] = entityComponentSignature;
 
     // Loop all the systems
     for (auto &system: systems) {
         const auto &systemComponentSignature = system.second->GetComponentSignature();
 
-        bool isInterested = (entityComponentSignature & systemComponentSignature) == systemComponentSignature;
+        bool isInterested = entityComponentSignature.Contains(systemComponentSignature);
 
         if (isInterested) {
             system.second->AddEntityToSystem(entity);
@@ -135,101 +446,224 @@ void Registry::AddEntityToSystems(Entity entity) {
     }
 }
 
+/// @brief Removes an entity from the systems that are processing it
+/// @param entity Entity to be removed
+/// @details Only the systems whose signature matches the entity's signature can contain it, so the
+/// others are skipped without touching their entity lists.
 void Registry::RemoveEntityFromSystems(Entity entity) {
-    for (auto system: systems) {
-        system.second->RemoveEntityFromSystem(entity);
+    auto &entitySystemSignature = entitySystemSignatures[entity.GetId()];
+
+    for (auto &system: systems) {
+        const auto &systemComponentSignature = system.second->GetComponentSignature();
+
+        if (entitySystemSignature.Contains(systemComponentSignature)) {
+            system.second->RemoveEntityFromSystem(entity);
+        }
+    }
+    entitySystemSignature.reset();
+}
+
+TagId Registry::GetTagId(const std::string &tag) {
+    auto tagId = tagIds.find(tag);
+    if (tagId != tagIds.end()) {
+        return tagId->second;
     }
+
+    const TagId newTagId = static_cast<TagId>(tagNames.size());
+    tagIds.emplace(tag, newTagId);
+    tagNames.push_back(tag);
+    entityPerTag.emplace_back();
+    return newTagId;
+}
+
+const std::string &Registry::GetTagName(TagId tag) const {
+    return tagNames[tag];
 }
 
 void Registry::TagEntity(Entity entity, const std::string &tag) {
-    entityPerTag.emplace(tag, entity);
-    tagPerEntity.emplace(entity.GetId(), tag);
+    TagEntity(entity, GetTagId(tag));
 }
 
-bool Registry::EntityHasTag(Entity entity, const std::string &tag) const {
-    if (tagPerEntity.find(entity.GetId()) == tagPerEntity.end()) {
-        return false;
+/// @brief Tags an entity, an entity has at most one tag and a tag is held by at most one entity
+/// @details The first assignment wins, like the previous map based implementation
+void Registry::TagEntity(Entity entity, TagId tag) {
+    if (CommandBuffer *commandBuffer = GetCommandBuffer()) {
+        commandBuffer->commands.emplace_back([this, entity, tag]() { TagEntity(entity, tag); });
+        return;
+    }
+
+    if (tagPerEntity[entity.GetId()] == INVALID_NAME_ID) {
+        tagPerEntity[entity.GetId()] = tag;
+    }
+    if (!IsEntityAlive(entityPerTag[tag])) {
+        entityPerTag[tag] = entity;
     }
-    return entityPerTag.find(tag)->second == entity;
+}
+
+bool Registry::EntityHasTag(Entity entity, const std::string &tag) const {
+    auto tagId = tagIds.find(tag);
+    return tagId != tagIds.end() && EntityHasTag(entity, tagId->second);
+}
+
+bool Registry::EntityHasTag(Entity entity, TagId tag) const {
+    return tag >= 0 && static_cast<std::size_t>(tag) < entityPerTag.size() && entityPerTag[tag] == entity;
 }
 
 Entity Registry::GetEntityByTag(const std::string &tag) const {
-    return entityPerTag.at(tag);
+    return GetEntityByTag(tagIds.at(tag));
+}
+
+Entity Registry::GetEntityByTag(TagId tag) const {
+    return entityPerTag[tag];
 }
 
 void Registry::RemoveEntityTag(Entity entity) {
-    auto taggedEntity = tagPerEntity.find(entity.GetId());
-    if (taggedEntity != tagPerEntity.end()) {
-        auto tag = taggedEntity->second;
-        entityPerTag.erase(tag);
-        tagPerEntity.erase(taggedEntity);
+    TagId &tag = tagPerEntity[entity.GetId()];
+    if (tag != INVALID_NAME_ID) {
+        if (entityPerTag[tag] == entity) {
+            entityPerTag[tag] = Entity();
+        }
+        tag = INVALID_NAME_ID;
     }
 }
 
+GroupId Registry::GetGroupId(const std::string &group) {
+    auto groupId = groupIds.find(group);
+    if (groupId != groupIds.end()) {
+        return groupId->second;
+    }
+
+    if (groupNames.size() >= MAX_GROUPS) {
+        Logger::Err("Unable to create group " + group + ", the maximum of " + std::to_string(MAX_GROUPS) +
+                    " groups was reached");
+        return INVALID_NAME_ID;
+    }
+
+    const GroupId newGroupId = static_cast<GroupId>(groupNames.size());
+    groupIds.emplace(group, newGroupId);
+    groupNames.push_back(group);
+    return newGroupId;
+}
+
+const std::string &Registry::GetGroupName(GroupId group) const {
+    return groupNames[group];
+}
+
 void Registry::GroupEntity(Entity entity, const std::string &group) {
-    entitiesPerGroup.emplace(group, std::set<Entity>());
-    entitiesPerGroup[group].emplace(entity);
-    groupPerEntity.emplace(entity.GetId(), group);
+    GroupEntity(entity, GetGroupId(group));
 }
 
-bool Registry::EntityBelongsToGroup(Entity entity, const std::string &group) const {
-    if (entitiesPerGroup.find(group) == entitiesPerGroup.end()) {
-        return false;
+void Registry::GroupEntity(Entity entity, GroupId group) {
+    if (group < 0) {
+        return;
+    }
+
+    if (CommandBuffer *commandBuffer = GetCommandBuffer()) {
+        commandBuffer->commands.emplace_back([this, entity, group]() { GroupEntity(entity, group); });
+        return;
     }
-    auto groupEntities = entitiesPerGroup.at(group);
-    return groupEntities.find(entity.GetId()) != groupEntities.end();
+
+    groupsPerEntity[entity.GetId()] |= std::uint64_t(1) << group;
+}
+
+bool Registry::EntityBelongsToGroup(Entity entity, const std::string &group) const {
+    auto groupId = groupIds.find(group);
+    return groupId != groupIds.end() && EntityBelongsToGroup(entity, groupId->second);
 }
 
 std::vector<Entity> Registry::GetEntitiesByGroup(const std::string &group) const {
-    auto &setOfEntities = entitiesPerGroup.at(group);
-    return std::vector<Entity>(setOfEntities.begin(), setOfEntities.end());
+    auto groupId = groupIds.find(group);
+    return groupId != groupIds.end() ? GetEntitiesByGroup(groupId->second) : std::vector<Entity>();
+}
+
+std::vector<Entity> Registry::GetEntitiesByGroup(GroupId group) const {
+    return GetEntitiesByGroup(group, std::allocator<Entity>());
 }
 
 void Registry::RemoveEntityGroup(Entity entity) {
-    auto groupedEntity = groupPerEntity.find(entity.GetId());
-    if (groupedEntity != groupPerEntity.end()) {
-        auto group = entitiesPerGroup.find(groupedEntity->second);
-        if (group != entitiesPerGroup.end()) {
-            auto entityInGroup = group->second.find(entity);
-            if (entityInGroup != group->second.end()) {
-                group->second.erase(entityInGroup);
-            }
-        }
-        groupPerEntity.erase(groupedEntity);
-    }
+    groupsPerEntity[entity.GetId()] = 0;
 }
 
 /// @brief Processes pending entity changes
-/// @details This method should:
-/// 1. Process entities in entitiesToBeAdd:
-///    - Initialize their data structures
-///    - Add them to relevant systems
-/// 2. Process entities in entitiesToBeKilled:
-///    - Remove them from all systems
-///    - Clean up their components
-///    - Free their IDs for reuse
-/// @note Currently unimplemented - marked as TODO
+/// @details All the changes queued since the last call are committed in batches:
+/// 0. Changes recorded in the command buffers of the jobs are replayed
+/// 1. The kill list is sorted and deduplicated once
+/// 2. Each system re-matches the created/changed entities: it only adds or removes the entities whose
+///    signature crossed its required set since the last update
+/// 3. Each system drops the killed entities it holds
+/// 4. Killed entities are grouped per component pool and each pool removes its batch in one pass
+/// 5. Killed entity ids are released for reuse with a new generation, tags and groups are cleaned up
 void Registry::Update() {
-    // Processing the entities that are waiting to be created to the active Systems
-    for (auto entity: entitiesToBeAdd) {
-        AddEntityToSystems(entity);
+    PlaybackCommandBuffers();
+
+    std::sort(entitiesToBeKilled.begin(), entitiesToBeKilled.end());
+    entitiesToBeKilled.erase(std::unique(entitiesToBeKilled.begin(), entitiesToBeKilled.end()), entitiesToBeKilled.end());
+
+    // Processing the entities that were created or had components added/removed
+    for (auto &system: systems) {
+        const auto &systemComponentSignature = system.second->GetComponentSignature();
+        for (auto entity: entitiesToBeRematched) {
+            const auto entityId = entity.GetId();
+            const bool wasInterested = entitySystemSignatures[entityId].Contains(systemComponentSignature);
+            const bool isInterested = entityComponentSignatures[entityId].Contains(systemComponentSignature);
+            if (isInterested && !wasInterested) {
+                system.second->AddEntityToSystem(entity);
+            } else if (wasInterested && !isInterested) {
+                system.second->RemoveEntityFromSystem(entity);
+            }
+        }
     }
+    for (auto entity: entitiesToBeRematched) {
+        entitySystemSignatures[entity.GetId()] = entityComponentSignatures[entity.GetId()];
+        isEntityPendingRematch[entity.GetId()] = 0;
+    }
+    entitiesToBeRematched.clear();
 
-    entitiesToBeAdd.clear();
+    if (entitiesToBeKilled.empty()) {
+        return;
+    }
 
     // Processing the entities that are waiting to be killed from the active Systems
-    for (auto entity: entitiesToBeKilled) {
-        RemoveEntityFromSystems(entity);
-        entityComponentSignatures[entity.GetId()].reset();
+    for (auto &system: systems) {
+        const auto &systemComponentSignature = system.second->GetComponentSignature();
+        for (auto entity: entitiesToBeKilled) {
+            if (entitySystemSignatures[entity.GetId()].Contains(systemComponentSignature)) {
+                system.second->RemoveEntityFromSystem(entity);
+            }
+        }
+    }
 
-        // Remove entity from the component pools
-        for (auto pool: componentPools) {
-            if (pool) {
-                pool->RemoveEntityFromPool(entity.GetId());
+    // Remove the killed entities from the component storage
+    if (storageMode == StorageMode::Archetypes) {
+        for (auto entity: entitiesToBeKilled) {
+            archetypeStorage->RemoveEntity(entity.GetId());
+        }
+    } else {
+        entityIdsToBeRemovedPerPool.resize(componentPools.size());
+        for (auto entity: entitiesToBeKilled) {
+            const auto &entityComponentSignature = entityComponentSignatures[entity.GetId()];
+            for (std::size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+                // Empty (tag) components only live in the signature and have no pool
+                if (entityComponentSignature.test(componentId) && componentPools[componentId]) {
+                    entityIdsToBeRemovedPerPool[componentId].push_back(entity.GetId());
+                }
+            }
+        }
+        for (std::size_t componentId = 0; componentId < componentPools.size(); componentId++) {
+            auto &entityIds = entityIdsToBeRemovedPerPool[componentId];
+            if (!entityIds.empty()) {
+                componentPools[componentId]->RemoveEntitiesFromPool(entityIds);
+                entityIds.clear();
             }
         }
+    }
 
-        // Make the entity id avaliable to reused
+    for (auto entity: entitiesToBeKilled) {
+        entityComponentSignatures[entity.GetId()].reset();
+        entitySystemSignatures[entity.GetId()].reset();
+
+        // Make the entity id available to be reused, bumping its generation invalidates the old handles
+        entityGenerations[entity.GetId()] = (entityGenerations[entity.GetId()] + 1) & ENTITY_GENERATION_MASK;
         freeIds.push_back(entity.GetId());
 
         RemoveEntityTag(entity);
@@ -237,3 +671,70 @@ void Registry::Update() {
     }
     entitiesToBeKilled.clear();
 }
+
+void Registry::RunScheduledSystems() {
+    systemScheduler->Run();
+}
+
+/// @brief Replays the structural changes recorded by the jobs since the last Update
+/// @details The entities reserved by every buffer are created first, so a recorded command can refer to an
+/// entity created by any job, then the commands run buffer by buffer in the recorded order and the kills of
+/// entities that are alive are queued
+void Registry::PlaybackCommandBuffers() {
+    for (auto &commandBuffer: commandBuffers) {
+        for (auto entity: commandBuffer.entitiesToBeCreated) {
+            const auto entityId = static_cast<std::size_t>(entity.GetId());
+            GrowEntityStorage(entityId);
+            MarkEntityForRematch(entity);
+
+            Logger::Log("Entity created with id = " + std::to_string(entityId));
+        }
+        commandBuffer.entitiesToBeCreated.clear();
+    }
+
+    for (auto &commandBuffer: commandBuffers) {
+        for (auto &command: commandBuffer.commands) {
+            command();
+        }
+        commandBuffer.commands.clear();
+    }
+
+    for (auto &commandBuffer: commandBuffers) {
+        for (auto entity: commandBuffer.entitiesToBeKilled) {
+            if (IsEntityAlive(entity)) {
+                entitiesToBeKilled.push_back(entity);
+            }
+        }
+        commandBuffer.entitiesToBeKilled.clear();
+    }
+}
+
+void Registry::ReserveEntities(int count) {
+    const auto capacity = static_cast<std::size_t>(std::min(std::max(count, 0), static_cast<int>(MAX_ENTITIES)));
+    entityComponentSignatures.reserve(capacity);
+    entitySystemSignatures.reserve(capacity);
+    tagPerEntity.reserve(capacity);
+    groupsPerEntity.reserve(capacity);
+    isEntityPendingRematch.reserve(capacity);
+    entityGenerations.reserve(capacity);
+    entitiesToBeRematched.reserve(capacity);
+}
+
+void Registry::GrowEntityStorage(std::size_t entityId) {
+    if (entityId >= entityComponentSignatures.size()) {
+        entityComponentSignatures.resize(entityId + 1);
+        entitySystemSignatures.resize(entityId + 1);
+        tagPerEntity.resize(entityId + 1, INVALID_NAME_ID);
+        groupsPerEntity.resize(entityId + 1, 0);
+        isEntityPendingRematch.resize(entityId + 1, 0);
+        entityGenerations.resize(entityId + 1, 0);
+    }
+}
+
+void Registry::MarkEntityForRematch(Entity entity) {
+    const auto entityId = entity.GetId();
+    if (!isEntityPendingRematch[entityId]) {
+        isEntityPendingRematch[entityId] = 1;
+        entitiesToBeRematched.push_back(entity);
+    }
+}
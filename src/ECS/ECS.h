@@ -2,27 +2,35 @@
 #define ECS_H
 
 #include "../Logger/Logger.h"
+#include "Signature.h"
+#include "SoALayout.h"
+#include "ArchetypeStorage.h"
+#include "SystemScheduler.h"
+#include "../JobSystem/JobSystem.h"
 
-#include <bitset>
 #include <vector>
-#include <set>
 #include <deque>
 #include <unordered_map>
 #include <typeindex>
+#include <tuple>
+#include <typeinfo>
 #include <memory>
-
-/// @brief Constant defining the maximum number of supported components
-const unsigned int MAX_COMPONENTS = 32;
-
-/// @brief Signature, we use a bitset (1s and 0s) to keep track of which components an entity has,
-/// and also helps keep track of which entities a system is interested in.
-typedef std::bitset<MAX_COMPONENTS> Signature;
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
 
 /// @brief Abstract base class for components
 /// Provides a way to manage unique IDs for component types
 struct IComponent {
 protected:
     static int nextId;
+
+    /// @brief Hands out the next component id, logging an error when MAX_COMPONENTS is exceeded
+    static int NewId();
 };
 
 /// @brief Template class to create components with unique IDs
@@ -33,22 +41,67 @@ public:
     /// @brief Gets a unique ID for component type T
     /// @return Unique component ID
     static int GetId() {
-        static auto id = nextId++;
+        static auto id = NewId();
         return id;
     }
 };
 
+/// @brief Empty component types (tag components like CameraFollowComponent) only live in the entity signature
+/// They have no pool and no archetype column, so marking an entity costs no memory.
+template<typename TComponent>
+constexpr bool IsEmptyComponent = std::is_empty<TComponent>::value;
+
+/// @brief Shared instance returned when an empty component is requested, it has no per-entity state
+template<typename TComponent>
+TComponent &GetEmptyComponent() {
+    static TComponent component;
+    return component;
+}
+
+/// @brief Interned tag name, see Registry::GetTagId
+typedef int TagId;
+
+/// @brief Interned group name, see Registry::GetGroupId
+typedef int GroupId;
+
+/// @brief Value of a tag/group id that does not name any tag/group
+const int INVALID_NAME_ID = -1;
+
+/// @brief Maximum number of different groups, the groups of an entity are stored as a 64-bit mask
+const unsigned int MAX_GROUPS = 64;
+
+/// @brief Number of bits of an entity handle used to store the entity index
+const unsigned int ENTITY_INDEX_BITS = 20;
+
+/// @brief Number of bits of an entity handle used to store the generation of the index
+const unsigned int ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+
+const std::uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+const std::uint32_t ENTITY_GENERATION_MASK = (1u << ENTITY_GENERATION_BITS) - 1;
+
+/// @brief Maximum number of entities that can be alive at the same time
+const std::uint32_t MAX_ENTITIES = ENTITY_INDEX_MASK;
+
 /// @brief Represents an entity in the ECS system
-/// An entity is basically an ID that can have associated components
+/// An entity is a 32-bit handle packing an index (used to address components and systems) and the
+/// generation of that index. Indices are recycled when entities are killed and the generation is bumped,
+/// so handles kept around after a kill (in events, Lua scripts, etc.) can be detected with IsAlive().
 class Entity {
 private:
-    int id;
+    std::uint32_t handle;
 
 public:
-    /// Constructor that initializes an entity with an ID
-    /// @param id Unique identifier for the entity
-    Entity(int id) : id(id) {
-    };
+    /// Constructor that creates an invalid entity handle
+    Entity() : handle(MAX_ENTITIES) {
+    }
+
+    /// Constructor that initializes an entity with an index and its generation
+    /// @param id Index of the entity
+    /// @param generation Generation of the index when the handle was created
+    explicit Entity(int id, std::uint32_t generation = 0)
+        : handle((static_cast<std::uint32_t>(id) & ENTITY_INDEX_MASK) |
+                 ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS)) {
+    }
 
     /// Default copy constructor
     /// @param entity Entity to be copied
@@ -57,42 +110,62 @@ public:
     void Kill();
 
     /// Gets the entity's ID
-    /// @return Entity's ID
-    int GetId() const;
+    /// @return Entity's index, shared with any previous entity that was killed and had its index recycled
+    int GetId() const { return static_cast<int>(handle & ENTITY_INDEX_MASK); }
 
-    // Manage entity tags and groups
+    /// Gets the generation of the entity index when this handle was created
+    /// @return Entity's generation
+    std::uint32_t GetGeneration() const { return handle >> ENTITY_INDEX_BITS; }
+
+    /// Gets the packed index and generation
+    /// @return Entity's handle
+    std::uint32_t GetHandle() const { return handle; }
+
+    /// Checks if the handle still refers to a live entity
+    /// @return false if the entity was killed (even if its index was recycled by a new entity)
+    bool IsAlive() const;
+
+    // Manage entity tags and groups, the id overloads skip the string lookup
     void Tag(const std::string &tag);
 
+    void Tag(TagId tag);
+
     bool HasTag(const std::string &tag) const;
 
+    bool HasTag(TagId tag) const;
+
     void Group(const std::string &group);
 
+    void Group(GroupId group);
+
     bool BelongsToGroup(const std::string &group) const;
 
+    bool BelongsToGroup(GroupId group) const;
+
     /// Default assignment operator
     /// @param other Entity to be assigned
     /// @return Reference to the current entity
     Entity &operator=(const Entity &other) = default;
 
-    /// Compares if two entities are equal based on their IDs
+    /// Compares if two entities are equal based on their handles
     /// @param other Entity to compare with
-    /// @return true if IDs are equal, false otherwise
-    bool operator==(const Entity &other) const { return id == other.id; }
+    /// @return true if index and generation are equal, false otherwise
+    bool operator==(const Entity &other) const { return handle == other.handle; }
 
-    /// Compares if two entities are different based on their IDs
+    /// Compares if two entities are different based on their handles
     /// @param other Entity to compare with
-    /// @return true if IDs are different, false otherwise
-    bool operator!=(const Entity &other) const { return id != other.id; }
+    /// @return true if index or generation are different, false otherwise
+    bool operator!=(const Entity &other) const { return handle != other.handle; }
 
-    /// Compares if current entity's ID is greater than another's
+    /// Compares if current entity's handle is greater than another's
     /// @param other Entity to compare with
-    /// @return true if current ID is greater, false otherwise
-    bool operator>(const Entity &other) const { return id > other.id; }
+    /// @return true if current handle is greater, false otherwise
+    bool operator>(const Entity &other) const { return handle > other.handle; }
 
-    /// Compares if current entity's ID is less than another's
+    /// Compares if current entity's handle is less than another's
     /// @param other Entity to compare with
-    /// @return true if current ID is less, false otherwise
-    bool operator<(const Entity &other) const { return id < other.id; }
+    /// @return true if current handle is less, false otherwise
+    bool operator<(const Entity &other) const { return handle < other.handle; }
 
     /// Adds a component to the entity
     /// @tparam TComponent Type of component to be added
@@ -112,14 +185,48 @@ public:
     template<typename TComponent>
     bool HasComponent() const;
 
-    /// Gets a component from the entity
+    /// Gets a component from the entity to read it
     /// @tparam TComponent Type of component to get
-    /// @return Reference to the component
+    /// @return Const reference to the component (a const copy for components stored as SoA, see ComponentConstRef)
     template<typename TComponent>
-    TComponent &GetComponent() const;
+    ComponentConstRef<TComponent> GetComponent() const;
 
-    /// Pointer to the registry that manages entities
-    class Registry *registry;
+    /// Gets a component from the entity to modify it, so that the change is detected (see Registry::GetMutableComponent)
+    /// @tparam TComponent Type of component to get
+    template<typename TComponent>
+    ComponentRef<TComponent> GetMutableComponent() const;
+
+    /// Registry that manages all entities, shared by every handle instead of stored in each one.
+    /// It is set by the Registry constructor, so only one registry can be in use at a time.
+    static class Registry *registry;
+};
+
+/// @brief Non-owning, read-only view over a contiguous range of entities
+/// Used to iterate the entities of a system without copying them. The underlying storage only changes
+/// inside Registry::Update, so a view stays valid for the whole frame even if entities are killed or
+/// created while iterating it (both operations are deferred to the next Registry::Update).
+class EntityView {
+private:
+    const Entity *first;
+    const Entity *last;
+
+public:
+    EntityView(const Entity *first, const Entity *last) : first(first), last(last) {
+    }
+
+    const Entity *begin() const { return first; }
+
+    const Entity *end() const { return last; }
+
+    /// @brief Gets the number of entities in the view
+    /// @return Number of entities
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+
+    /// @brief Checks if the view has no entities
+    /// @return True if the view is empty
+    bool empty() const { return first == last; }
+
+    const Entity &operator[](std::size_t index) const { return first[index]; }
 };
 
 /// @brief System that processes entities with a specific component signature
@@ -129,6 +236,18 @@ private:
     Signature componentSignature;
     std::vector<Entity> entities;
 
+    /// @brief Position of each entity inside the entities vector, -1 if the entity is not in the system
+    /// [Vector index = entity id]
+    std::vector<int> entityIndices;
+
+    /// @brief Components the system reads and writes while updating, used by the SystemScheduler
+    Signature componentReads;
+    Signature componentWrites;
+
+    /// @brief Components whose pool the system reorders while updating, see Registry::AlignComponentPool
+    Signature componentOrders;
+    bool declaresComponentAccess = false;
+
 public:
     System() = default;
 
@@ -142,9 +261,17 @@ public:
     /// @param entity Pointer to the entity to be removed
     void RemoveEntityFromSystem(Entity entity);
 
+    /// @brief Checks if an entity is processed by this system
+    /// @param entity Entity to check
+    /// @return true if the entity is in the system
+    bool HasEntity(Entity entity) const {
+        const auto entityId = static_cast<std::size_t>(entity.GetId());
+        return entityId < entityIndices.size() && entityIndices[entityId] >= 0;
+    }
+
     /// @brief Gets all entities managed by this system
-    /// @return Vector of entities in the system
-    std::vector<Entity> GetSystemEntities() const;
+    /// @return Non-owning view over the entities in the system, valid until the next Registry::Update
+    EntityView GetSystemEntities() const;
 
     /// @brief Gets the component signature of the system
     /// @return Reference to the component signature
@@ -155,6 +282,87 @@ public:
     /// @tparam TComponent Type of the required component
     template<typename TComponent>
     void RequireComponent();
+
+    /// @brief Declares that the system update reads a component type
+    template<typename TComponent>
+    void ReadComponent();
+
+    /// @brief Declares that the system update modifies a component type
+    template<typename TComponent>
+    void WriteComponent();
+
+    /// @brief Declares that the system update reorders the pool of a component type, which every other system
+    /// that uses the pool sees (e.g. in the dense order of the views). It conflicts like a write.
+    template<typename TComponent>
+    void OrderComponent();
+
+    /// @brief Checks if the system declared OrderComponent<TComponent>
+    template<typename TComponent>
+    bool OrdersComponent() const;
+
+    /// @brief Checks if the system must run alone
+    /// @return true when the system did not declare its component access, e.g. because it creates entities,
+    /// adds/removes components or emits events
+    bool IsExclusive() const { return !declaresComponentAccess; }
+
+    /// @brief Checks if the updates of two systems can not run at the same time
+    /// @param other System to compare with
+    /// @return true if one of them is exclusive or writes a component the other reads or writes
+    bool ConflictsWith(const System &other) const;
+};
+
+/// @brief Gets a readable name of a type from typeid(T).name(), e.g. "TransformComponent"
+std::string GetTypeName(const char *mangledName);
+
+/// @brief Memory and occupancy of a component pool, see Registry::GetStats
+/// The bytes only count the pool arrays, not the memory owned by the components themselves (e.g. strings).
+struct PoolStats {
+    int componentId = 0;
+    std::string componentName;
+
+    /// @brief Live components, and the most the pool ever held
+    int size = 0;
+    int peakSize = 0;
+
+    /// @brief Components the dense arrays hold without reallocating, they never shrink
+    int capacity = 0;
+
+    /// @brief Bytes of the live components (with their entity ids and change ticks), and bytes allocated by
+    /// the dense arrays and the sparse pages
+    std::size_t bytesUsed = 0;
+    std::size_t bytesReserved = 0;
+
+    /// @brief Number of times the dense arrays were reallocated
+    int numGrowths = 0;
+
+    /// @brief Share of the allocated bytes that holds no live component, e.g. left behind by a dead wave
+    double fragmentation = 0.0;
+};
+
+/// @brief Number of entities held by a system, see Registry::GetStats
+struct SystemStats {
+    std::string systemName;
+    int numEntities = 0;
+};
+
+/// @brief Snapshot of the memory and occupancy of a registry
+struct RegistryStats {
+    /// @brief Entity ids handed out so far, the ones in use and the ones waiting to be reused
+    int numEntities = 0;
+
+    /// @brief Entities that are alive, the ids reserved by jobs are only counted after the next Update
+    int numLiveEntities = 0;
+    int numFreeIds = 0;
+
+    /// @brief One entry per component pool, empty in archetype mode
+    std::vector<PoolStats> pools;
+
+    std::vector<SystemStats> systems;
+
+    /// @brief Archetype mode: number of archetypes and chunks, and the bytes allocated by the chunks
+    int numArchetypes = 0;
+    int numChunks = 0;
+    std::size_t chunkBytes = 0;
 };
 
 /// @brief Interface for component pools
@@ -163,28 +371,116 @@ class IPool {
 public:
     virtual ~IPool() = default;
 
+    /// @brief Gets the memory and occupancy of the pool
+    virtual PoolStats GetStats() const = 0;
+
     virtual void RemoveEntityFromPool(int entityId) = 0;
+
+    /// @brief Removes the components of a batch of entities in a single pass
+    /// @param entityIds Entities that have a component in this pool
+    virtual void RemoveEntitiesFromPool(const std::vector<int> &entityIds) = 0;
 };
 
 /// @brief Type-safe pool for storing components of a specific type
-/// Provides contiguous memory storage for better cache performance
+/// Implemented as a paged sparse set: components and their owner entity ids are packed in two dense
+/// arrays, while a sparse array (indexed by entity id and allocated in pages) stores the dense index of
+/// each entity. Lookups, insertions and removals are O(1) with no hashing involved.
+/// Component types with an SoALayout are packed as one array per field and accessed through their proxy.
+/// Every packed component carries the change tick of its last change (see Registry::AdvanceChangeTick): it is
+/// stamped when the component is added or replaced and by the mutable accessors GetMutable/MarkChanged, not by
+/// Get or operator[], so only writers that go through them are detected.
 /// @tparam T Component type stored in this pool
 template<typename T>
 class Pool : public IPool {
 private:
-    /// @brief Vector storing the actual component data
-    std::vector<T> data;
-    int size;
+    /// @brief Number of entity ids covered by each page of the sparse array
+    static constexpr int SPARSE_PAGE_SIZE = 4096;
+
+    /// @brief Marks a sparse slot that does not point to any dense index
+    static constexpr int INVALID_INDEX = -1;
+
+    /// @brief Packed component data [dense index = position of the component], one array per field for SoA types
+    typename std::conditional<IsSoAComponent<T>, SoAArray<T>, std::vector<T> >::type data;
+
+    /// @brief Packed entity ids [dense index = same position of data]
+    std::vector<int> entities;
+
+    /// @brief Change tick of each packed component [dense index = same position of data]
+    std::vector<std::uint32_t> versions;
+
+    /// @brief Highest change tick of any component, and of the last addition, removal or reordering
+    std::atomic<std::uint32_t> lastChangeVersion{0};
+    std::uint32_t lastStructureVersion = 0;
+
+    /// @brief Change tick of the registry that owns the pool, nullptr leaves every version at 0
+    const std::atomic<std::uint32_t> *changeTick;
+
+    /// @brief Reallocations of the dense arrays and the most components ever held, for GetStats
+    int numGrowths = 0;
+    int peakSize = 0;
+
+    std::uint32_t CurrentVersion() const {
+        return changeTick ? changeTick->load(std::memory_order_relaxed) : 0;
+    }
+
+    /// @brief Gets a packed component to read it, by value for SoA types that have no object to refer to
+    decltype(auto) ReadAt(int index) {
+        if constexpr (IsSoAComponent<T>) {
+            return static_cast<T>(data[index]);
+        } else {
+            return static_cast<const T &>(data[index]);
+        }
+    }
+
+    /// @brief Raises lastChangeVersion, jobs may stamp components of the same pool at the same time
+    void RaiseLastChangeVersion(std::uint32_t version) {
+        std::uint32_t last = lastChangeVersion.load(std::memory_order_relaxed);
+        while (last < version && !lastChangeVersion.compare_exchange_weak(last, version, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// @brief Paged sparse array [entity id = dense index of its component]
+    std::vector<std::unique_ptr<int[]> > sparse;
 
-    std::unordered_map<int, int> entityIdToIndex;
-    std::unordered_map<int, int> indexToEntityId;
+    /// @brief Gets the sparse slot of an entity, allocating its page when needed
+    /// @param entityId Entity id to be mapped
+    /// @return Reference to the sparse slot of the entity
+    int &SparseSlot(int entityId) {
+        const std::size_t page = entityId / SPARSE_PAGE_SIZE;
+        if (page >= sparse.size()) {
+            sparse.resize(page + 1);
+        }
+        if (!sparse[page]) {
+            sparse[page] = std::make_unique<int[]>(SPARSE_PAGE_SIZE);
+            std::fill_n(sparse[page].get(), SPARSE_PAGE_SIZE, INVALID_INDEX);
+        }
+        return sparse[page][entityId % SPARSE_PAGE_SIZE];
+    }
+
+    /// @brief Swaps two packed components and their entity ids
+    void SwapDense(int a, int b) {
+        if constexpr (IsSoAComponent<T>) {
+            T temporary = data[a];
+            data[a] = data[b];
+            data[b] = temporary;
+        } else {
+            std::swap(data[a], data[b]);
+        }
+        std::swap(entities[a], entities[b]);
+        std::swap(versions[a], versions[b]);
+        SparseSlot(entities[a]) = a;
+        SparseSlot(entities[b]) = b;
+        lastStructureVersion = CurrentVersion();
+    }
 
 public:
     /// @brief Constructor that pre-allocates space for components
-    /// @param size Initial size of the pool
-    Pool(int capacity = 100) {
-        size = 0;
-        data.resize(capacity);
+    /// @param capacity Initial number of components the pool can hold without reallocating
+    /// @param changeTick Change tick used to stamp the changes, usually the one of the owning registry
+    Pool(int capacity = 100, const std::atomic<std::uint32_t> *changeTick = nullptr) : changeTick(changeTick) {
+        data.reserve(capacity);
+        entities.reserve(capacity);
+        versions.reserve(capacity);
     }
 
     virtual ~Pool() = default;
@@ -192,87 +488,394 @@ public:
     /// @brief Checks if the pool is empty
     /// @return True if pool contains no elements
     bool IsEmpty() const {
-        return size == 0;
+        return data.empty();
     }
 
     /// @brief Gets the current size of the pool
-    /// @return Number of elements the pool can hold
+    /// @return Number of components stored in the pool
     int GetSize() const {
-        return size;
+        return static_cast<int>(data.size());
+    }
+
+    /// @brief Gets the number of components the pool can hold without reallocating
+    int GetCapacity() const {
+        return static_cast<int>(data.capacity());
     }
 
-    /// @brief Resizes the pool to hold a specific number of elements
-    /// @param n New size for the pool
-    void Resize(int n) {
-        data.resize(n);
+    /// @brief Reserves space in the dense arrays for a specific number of elements
+    /// @param n Number of components the pool must hold without reallocating
+    void Reserve(int n) {
+        if (n > GetCapacity()) {
+            numGrowths++;
+        }
+        data.reserve(n);
+        entities.reserve(n);
+        versions.reserve(n);
     }
 
     /// @brief Removes all elements from the pool
     void Clear() {
         data.clear();
-        size = 0;
+        entities.clear();
+        versions.clear();
+        sparse.clear();
+        lastStructureVersion = CurrentVersion();
     }
 
-    /// @brief Adds a new object to the pool
-    /// @param object Object to be added
-    void Add(T object) {
-        data.push_back(object);
+    /// @brief Checks if an entity has a component stored in this pool
+    /// @param entityId Entity id to check
+    /// @return True if the entity has a component in the pool
+    bool Contains(int entityId) const {
+        const std::size_t page = entityId / SPARSE_PAGE_SIZE;
+        return page < sparse.size() && sparse[page] && sparse[page][entityId % SPARSE_PAGE_SIZE] != INVALID_INDEX;
+    }
+
+    /// @brief Constructs a component in place for an entity, replacing the existing one if any
+    /// @param entityId Entity that owns the component
+    /// @param args Arguments forwarded to the component constructor
+    /// @return Reference to the stored component
+    template<typename... TArgs>
+    ComponentRef<T> Emplace(int entityId, TArgs &&... args) {
+        const std::uint32_t version = CurrentVersion();
+        RaiseLastChangeVersion(version);
+        int &index = SparseSlot(entityId);
+        if (index != INVALID_INDEX) {
+            versions[index] = version;
+            data[index] = T(std::forward<TArgs>(args)...);
+            return data[index];
+        }
+        index = static_cast<int>(data.size());
+        if (data.size() == data.capacity()) {
+            numGrowths++;
+        }
+        peakSize = std::max(peakSize, index + 1);
+        entities.push_back(entityId);
+        versions.push_back(version);
+        lastStructureVersion = version;
+        return data.emplace_back(std::forward<TArgs>(args)...);
     }
 
-    /// @brief Sets an object at a specific index in the pool
-    /// @param index Position where to set the object
+    /// @brief Sets the component of an entity, adding it to the pool if needed
+    /// @param entityId Entity that owns the component
     /// @param object Object to be set
     void Set(int entityId, T object) {
-        if (entityIdToIndex.find(entityId) != entityIdToIndex.end()) {
-            int index = entityIdToIndex[entityId];
-            data[index] = object;
-        } else {
-            int index = size;
-            entityIdToIndex.emplace(entityId, index);
-            indexToEntityId.emplace(index, entityId);
-            if (static_cast<std::size_t>(index) >= data.capacity()) {
-                data.resize(size * 2);
-            }
-            data[index] = object;
-            size++;
-        }
+        Emplace(entityId, std::move(object));
     }
 
+    /// @brief Removes the component of an entity by moving the last packed component into its slot
+    /// @param entityId Entity that owns the component (it must be present in the pool)
     void Remove(int entityId) {
-        int indexOfRemoved = entityIdToIndex[entityId];
-        int indexOfLast = size - 1;
-        data[indexOfRemoved] = data[indexOfLast];
-
-        int entityIdOfLastElement = indexToEntityId[indexOfLast];
-        entityIdToIndex[entityIdOfLastElement] = indexOfRemoved;
-        indexToEntityId[indexOfRemoved] = entityIdOfLastElement;
-
-        entityIdToIndex.erase(entityId);
-        indexToEntityId.erase(indexOfLast);
+        int &indexOfRemoved = SparseSlot(entityId);
+        const int indexOfLast = static_cast<int>(data.size()) - 1;
+
+        if (indexOfRemoved != indexOfLast) {
+            const int entityIdOfLastElement = entities[indexOfLast];
+            data[indexOfRemoved] = std::move(data[indexOfLast]);
+            entities[indexOfRemoved] = entityIdOfLastElement;
+            versions[indexOfRemoved] = versions[indexOfLast];
+            SparseSlot(entityIdOfLastElement) = indexOfRemoved;
+        }
 
-        size--;
+        data.pop_back();
+        entities.pop_back();
+        versions.pop_back();
+        indexOfRemoved = INVALID_INDEX;
+        lastStructureVersion = CurrentVersion();
     }
 
     void RemoveEntityFromPool(int entityId) override {
-        if (entityIdToIndex.find(entityId) != entityIdToIndex.end()) {
+        if (Contains(entityId)) {
             Remove(entityId);
         }
     }
 
-    /// @brief Gets an object from a specific index in the pool
-    /// @param entityId Position of the object to retrieve
+    void RemoveEntitiesFromPool(const std::vector<int> &entityIds) override {
+        for (auto entityId: entityIds) {
+            Remove(entityId);
+        }
+    }
+
+    /// @brief Reorders the packed components so that the component of entityIds[k] is at dense index k
+    /// Lets a loop walk two pools in lockstep, e.g. the transforms of the entities of the rigidbody pool.
+    /// Once aligned, keeping the pools aligned only swaps the few components that were added or removed.
+    /// @param entityIds Entity ids in the wanted order
+    /// @param count Number of entity ids
+    /// @return false if some entity is not in the pool, the pool may then be partially reordered
+    bool AlignTo(const int *entityIds, int count) {
+        for (int k = 0; k < count; k++) {
+            if (entities[k] == entityIds[k]) {
+                continue;
+            }
+            if (!Contains(entityIds[k])) {
+                return false;
+            }
+            SwapDense(k, SparseSlot(entityIds[k]));
+        }
+        return true;
+    }
+
+    /// @brief Gets the component of an entity
+    /// @param entityId Entity that owns the component (it must be present in the pool)
     /// @return Reference to the requested object
-    T &Get(int entityId) {
-        int index = entityIdToIndex[entityId];
-        return static_cast<T &>(data[index]);
+    ComponentRef<T> Get(int entityId) {
+        return data[sparse[entityId / SPARSE_PAGE_SIZE][entityId % SPARSE_PAGE_SIZE]];
+    }
+
+    /// @brief Gets the component of an entity to modify it, stamping it as changed
+    /// @param entityId Entity that owns the component (it must be present in the pool)
+    ComponentRef<T> GetMutable(int entityId) {
+        const int index = sparse[entityId / SPARSE_PAGE_SIZE][entityId % SPARSE_PAGE_SIZE];
+        MarkRangeChanged(index, 1);
+        return data[index];
+    }
+
+    /// @brief Stamps the component of an entity as changed, for writers that went through Get or the views
+    /// @param entityId Entity that owns the component (it must be present in the pool)
+    void MarkChanged(int entityId) {
+        MarkRangeChanged(sparse[entityId / SPARSE_PAGE_SIZE][entityId % SPARSE_PAGE_SIZE], 1);
+    }
+
+    /// @brief Stamps the packed components [first, first + count) as changed, for loops over GetColumns
+    /// Jobs can stamp disjoint ranges of the same pool at the same time.
+    void MarkRangeChanged(int first, int count) {
+        const std::uint32_t version = CurrentVersion();
+        std::fill_n(versions.begin() + first, count, version);
+        RaiseLastChangeVersion(version);
     }
 
-    /// @brief Array access operator
-    /// @param index Position of the object to retrieve
+    /// @brief Gets the change tick of the packed component at a dense index
+    std::uint32_t GetVersion(int index) const {
+        return versions[index];
+    }
+
+    /// @brief Checks if a component was added, replaced or stamped as changed after a change tick
+    bool HasChangedSince(std::uint32_t version) const {
+        return lastChangeVersion.load(std::memory_order_relaxed) > version;
+    }
+
+    /// @brief Checks if components were added, removed or reordered after a change tick
+    bool HasStructureChangedSince(std::uint32_t version) const {
+        return lastStructureVersion > version;
+    }
+
+    /// @brief Keeps the packed components sorted, e.g. the sprites by z-index so that iterating the pool
+    /// yields them in drawing order
+    /// @param compare Strict weak ordering of two components, equal ones keep their relative order
+    /// @param sortedVersion Change tick the pool was last sorted at, only the changes after it are checked
+    /// @return true if the components had to be reordered
+    template<typename TCompare>
+    bool Sort(TCompare compare, std::uint32_t sortedVersion) {
+        const int count = GetSize();
+        auto isPairSorted = [this, &compare](int index) {
+            return !compare(ReadAt(index + 1), ReadAt(index));
+        };
+
+        bool isSorted = true;
+        if (HasStructureChangedSince(sortedVersion)) {
+            for (int i = 0; i + 1 < count && isSorted; i++) {
+                isSorted = isPairSorted(i);
+            }
+        } else if (HasChangedSince(sortedVersion)) {
+            // Nothing moved, so only the pairs around a changed component can be out of order
+            for (int i = 0; i < count && isSorted; i++) {
+                if (versions[i] > sortedVersion) {
+                    isSorted = (i == 0 || isPairSorted(i - 1)) && (i + 1 == count || isPairSorted(i));
+                }
+            }
+        }
+        if (isSorted) {
+            return false;
+        }
+
+        // order[k] is the dense index of the component that goes to position k
+        std::vector<int> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this, &compare](int a, int b) {
+            return compare(ReadAt(a), ReadAt(b));
+        });
+
+        // Apply the permutation one cycle at a time, order[k] = k marks the positions already in place
+        for (int k = 0; k < count; k++) {
+            int current = k;
+            while (order[current] != k) {
+                const int next = order[current];
+                SwapDense(current, next);
+                order[current] = current;
+                current = next;
+            }
+            order[current] = current;
+        }
+        lastStructureVersion = CurrentVersion();
+        return true;
+    }
+
+    /// @brief Gets the packed array of entity ids, in the same order as the packed components
+    /// @return Pointer to the first of GetSize() entity ids
+    const int *GetEntityIds() const {
+        return entities.data();
+    }
+
+    /// @brief Gets the entity id that owns the component at a dense index
+    /// @param index Dense index of the component
+    /// @return Entity id of the owner
+    int GetEntityId(int index) const {
+        return entities[index];
+    }
+
+    /// @brief Array access operator over the packed components
+    /// @param index Dense index of the object to retrieve
     /// @return Reference to the requested object
-    T &operator[](unsigned int index) {
+    ComponentRef<T> operator[](unsigned int index) {
         return data[index];
     }
+
+    PoolStats GetStats() const override {
+        constexpr std::size_t bytesPerComponent = sizeof(T) + sizeof(int) + sizeof(std::uint32_t);
+
+        PoolStats stats;
+        stats.componentId = Component<T>::GetId();
+        stats.componentName = GetTypeName(typeid(T).name());
+        stats.size = GetSize();
+        stats.peakSize = peakSize;
+        stats.capacity = GetCapacity();
+        stats.numGrowths = numGrowths;
+        stats.bytesUsed = stats.size * bytesPerComponent;
+        stats.bytesReserved = stats.capacity * bytesPerComponent + sparse.capacity() * sizeof(sparse[0]);
+        for (const auto &page: sparse) {
+            if (page) {
+                stats.bytesReserved += SPARSE_PAGE_SIZE * sizeof(int);
+            }
+        }
+        if (stats.bytesReserved > 0) {
+            stats.fragmentation = 1.0 - static_cast<double>(stats.bytesUsed) / stats.bytesReserved;
+        }
+        return stats;
+    }
+
+    /// @brief Gets the field arrays of an SoA component type, in the same order as GetEntityIds
+    auto &GetColumns() {
+        static_assert(IsSoAComponent<T>, "GetColumns requires a component with an SoALayout");
+        return data.GetColumns();
+    }
+};
+
+/// @brief Structural changes recorded by a thread while it runs a job, replayed in Registry::Update
+/// Each thread of the JobSystem owns one buffer, so recording needs no locking.
+struct CommandBuffer {
+    /// @brief Entities whose ids were reserved by CreateEntity
+    std::vector<Entity> entitiesToBeCreated;
+
+    /// @brief Deferred calls such as AddComponent/RemoveComponent, replayed in the recorded order
+    std::vector<std::function<void()> > commands;
+
+    std::vector<Entity> entitiesToBeKilled;
+};
+
+/// @brief Storage backends available for the component data of a Registry
+enum class StorageMode {
+    /// One sparse-set Pool per component type
+    Pools,
+    /// Entities with the same signature packed together in fixed-size chunks (see ArchetypeStorage)
+    Archetypes
+};
+
+/// @brief List of component types that a Registry::View must skip
+/// Example: registry->View<TransformComponent, RigidbodyComponent>(Exclude<ProjectileComponent>())
+/// @tparam TExcluded Component types an entity must not have
+template<typename... TExcluded>
+struct Exclude {
+};
+
+template<typename TExclude, typename... TComponents>
+class RegistryView;
+
+/// @brief Template of an entity: the components it starts with, their default values and its groups
+/// Registry::Instantiate creates copies of it in one batch: every pool grows once, each copy gets the whole
+/// signature at once and joins its systems in the next Update.
+/// Example: Prefab bullet; bullet.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4); registry->Instantiate(bullet, 100);
+class Prefab {
+private:
+    /// @brief Type-erased default value of a component
+    struct IPrefabComponent {
+        virtual ~IPrefabComponent() = default;
+
+        /// @brief Makes room in the storage of the component for count more copies
+        virtual void Reserve(Registry &registry, int count) const = 0;
+
+        /// @brief Constructs a copy for an entity whose signature (and archetype) already include the component
+        virtual void Construct(Registry &registry, int entityId) const = 0;
+
+        /// @brief Adds a copy through Entity::AddComponent, used when instantiating from a job
+        virtual void AddTo(Entity entity) const = 0;
+    };
+
+    template<typename TComponent>
+    struct PrefabComponent : IPrefabComponent {
+        TComponent value;
+
+        template<typename... TArgs>
+        explicit PrefabComponent(TArgs &&... args) : value(std::forward<TArgs>(args)...) {}
+
+        void Reserve(Registry &registry, int count) const override;
+
+        void Construct(Registry &registry, int entityId) const override;
+
+        void AddTo(Entity entity) const override;
+    };
+
+    Signature signature;
+
+    /// @brief Default value of each component, paired with its component id
+    std::vector<std::pair<int, std::unique_ptr<IPrefabComponent> > > components;
+
+    /// @brief Groups of the copies, bit N set means the group with id N
+    std::uint64_t groups = 0;
+
+    friend class Registry;
+
+public:
+    /// @brief Adds a component (or replaces its default value) to the prefab
+    /// @tparam TComponent Type of component to add
+    /// @param args Arguments forwarded to the component constructor
+    template<typename TComponent, typename... TArgs>
+    Prefab &AddComponent(TArgs &&... args) {
+        const int componentId = Component<TComponent>::GetId();
+        auto component = std::make_unique<PrefabComponent<TComponent> >(std::forward<TArgs>(args)...);
+        for (auto &entry: components) {
+            if (entry.first == componentId) {
+                entry.second = std::move(component);
+                return *this;
+            }
+        }
+        components.emplace_back(componentId, std::move(component));
+        signature.set(componentId);
+        return *this;
+    }
+
+    template<typename TComponent>
+    bool HasComponent() const {
+        return signature.test(Component<TComponent>::GetId());
+    }
+
+    /// @brief Gets the default value of a component, the next copies are made from it
+    /// @tparam TComponent Type of component to get (the prefab must have it)
+    template<typename TComponent>
+    TComponent &GetComponent() {
+        const int componentId = Component<TComponent>::GetId();
+        auto entry = std::find_if(components.begin(), components.end(),
+                                  [componentId](const auto &component) { return component.first == componentId; });
+        return static_cast<PrefabComponent<TComponent> *>(entry->second.get())->value;
+    }
+
+    /// @brief Adds the copies to a group
+    Prefab &Group(GroupId group) {
+        if (group >= 0) {
+            groups |= std::uint64_t(1) << group;
+        }
+        return *this;
+    }
+
+    const Signature &GetSignature() const { return signature; }
 };
 
 /// @brief Central registry that manages entities, components, and systems
@@ -287,63 +890,255 @@ private:
     // [Pool index = entity id]
     std::vector<std::shared_ptr<IPool> > componentPools;
 
+    /// @brief Backend used to store the component data
+    StorageMode storageMode;
+
+    /// @brief Chunked component storage, only created when storageMode is StorageMode::Archetypes
+    std::unique_ptr<ArchetypeStorage> archetypeStorage;
+
     // Vector of component signatures per entity, saying which component is turned "on" for a given entity
     // [Vector index = entity id]
     std::vector<Signature> entityComponentSignatures;
 
+    // Current generation of each entity index, bumped every time an entity with that index is killed
+    // [Vector index = entity id]
+    std::vector<std::uint32_t> entityGenerations;
+
     /// @brief Map of systems indexed by their type
     /// Stores all registered systems in the ECS
     std::unordered_map<std::type_index, std::shared_ptr<System> > systems;
 
-    /// @brief Sets of entities pending addition or removal
-    /// Used to manage entity lifecycle during updates
-    std::set<Entity> entitiesToBeAdd;
-    std::set<Entity> entitiesToBeKilled;
+    // Signature each entity had when the systems were last updated, the systems hold the entity when this
+    // signature matches theirs
+    // [Vector index = entity id]
+    std::vector<Signature> entitySystemSignatures;
+
+    /// @brief Entities created or whose signature changed since the last Registry::Update
+    /// Each entity is queued once, isEntityPendingRematch flags the queued ones [vector index = entity id]
+    std::vector<Entity> entitiesToBeRematched;
+    std::vector<std::uint8_t> isEntityPendingRematch;
 
-    std::unordered_map<std::string, Entity> entityPerTag;
-    std::unordered_map<int, std::string> tagPerEntity;
+    /// @brief Entities pending removal, they are deduplicated once per Registry::Update
+    std::vector<Entity> entitiesToBeKilled;
 
-    std::unordered_map<std::string, std::set<Entity> > entitiesPerGroup;
-    std::unordered_map<int, std::string> groupPerEntity;
+    /// @brief Command buffer of each thread of the job system
+    /// [Vector index = JobSystem::GetThreadIndex()]
+    std::vector<CommandBuffer> commandBuffers;
+
+    /// @brief Guards the entity id reservation of CreateEntity calls recorded from jobs
+    std::mutex entityCreationMutex;
+
+    /// @brief Ids of the killed entities grouped per component pool, reused every Registry::Update
+    /// [Vector index = component type id]
+    std::vector<std::vector<int> > entityIdsToBeRemovedPerPool;
+
+    // Interned tag and group names [vector index = tag/group id]
+    std::unordered_map<std::string, TagId> tagIds;
+    std::vector<std::string> tagNames;
+    std::unordered_map<std::string, GroupId> groupIds;
+    std::vector<std::string> groupNames;
+
+    // Entity holding each tag, an invalid handle when nobody holds it [vector index = tag id]
+    std::vector<Entity> entityPerTag;
+
+    // Tag of each entity, INVALID_NAME_ID when untagged [vector index = entity id]
+    std::vector<TagId> tagPerEntity;
+
+    // Groups of each entity, bit N set means the entity belongs to the group with id N [vector index = entity id]
+    std::vector<std::uint64_t> groupsPerEntity;
 
     /// @brief List of free entity ids that were previously removed
     std::deque<int> freeIds;
 
+    /// @brief Prefabs declared by name (e.g. by the level scripts)
+    std::unordered_map<std::string, Prefab> prefabs;
+
+    /// @brief Change tick stamped on the components that change, see AdvanceChangeTick
+    std::atomic<std::uint32_t> changeTick{1};
+
+    /// @brief Worker threads shared by the system scheduler and ParallelForEach
+    std::unique_ptr<JobSystem> jobSystem;
+
+    /// @brief Runs the system updates scheduled for the current frame
+    std::unique_ptr<SystemScheduler> systemScheduler;
+
+    /// @brief Gets the command buffer of the calling thread
+    /// @return Buffer to record structural changes into, or nullptr when the thread is not running a job and
+    /// the changes can be applied directly
+    CommandBuffer *GetCommandBuffer() {
+        return JobSystem::IsRunningJob() ? &commandBuffers[jobSystem->GetThreadIndex()] : nullptr;
+    }
+
+    /// @brief Replays the structural changes recorded by the jobs since the last Update
+    void PlaybackCommandBuffers();
+
+    /// @brief Grows the per-entity vectors so they can hold an entity index
+    void GrowEntityStorage(std::size_t entityId);
+
+    /// @brief Queues an entity whose signature changed, its systems are updated in the next Update
+    void MarkEntityForRematch(Entity entity);
+
+    /// @brief Takes a free entity id (outside jobs) and queues the new entity to join its systems
+    /// @return New entity, or an invalid handle when MAX_ENTITIES is reached
+    Entity AllocateEntity();
+
+    /// @brief Gets the pool of a component type, creating it if needed
+    template<typename TComponent>
+    Pool<TComponent> *GetOrCreateComponentPool();
+
+    /// @brief Makes room in the storage of a component type for count more entities (see Instantiate)
+    template<typename TComponent>
+    void ReserveComponentCopies(int count);
+
+    /// @brief Constructs a component of an entity whose signature (and archetype) already include it
+    template<typename TComponent>
+    void ConstructComponentCopy(int entityId, const TComponent &value);
+
+    /// @brief Stores a component of an entity for AddComponents, once the entity is in its new archetype
+    /// @param hadComponent true if the entity already had the component, it is then replaced
+    template<typename TComponent>
+    void StoreComponent(int entityId, bool hadComponent, TComponent &&component);
+
+    friend class Prefab;
+
 public:
-    Registry() {
+    /// @brief Creates a registry
+    /// @param storageMode Backend used to store the component data, it can not be changed afterwards
+    Registry(StorageMode storageMode = StorageMode::Pools) : storageMode(storageMode) {
+        if (storageMode == StorageMode::Archetypes) {
+            archetypeStorage = std::make_unique<ArchetypeStorage>();
+        }
+        jobSystem = std::make_unique<JobSystem>();
+        commandBuffers.resize(jobSystem->GetNumWorkers() + 1);
+        systemScheduler = std::make_unique<SystemScheduler>(*jobSystem);
+        Entity::registry = this;
         Logger::Log("Registry constructor called!");
     }
 
     ~Registry() {
+        if (Entity::registry == this) {
+            Entity::registry = nullptr;
+        }
         Logger::Log("Registry destructor called!");
     }
 
+    /// @brief Gets the backend used to store the component data
+    /// @return Storage mode selected at construction
+    StorageMode GetStorageMode() const { return storageMode; }
+
     /// @brief Updates the registry state
     /// Processes pending entity additions and removals
     void Update();
 
     /// @brief Creates a new entity in the system
     /// @return Newly created entity
+    /// @details When called from a job only the entity id is reserved, the entity is created (and its recorded
+    /// components added) in the next Update
     Entity CreateEntity();
 
+    /// @brief Creates many entities at once
+    /// @param count Number of entities
+    /// @return New entities, they join their systems in the next Update
+    /// @details The per-entity storage grows once and there is a single log line, see AddComponents to fill them
+    std::vector<Entity> CreateEntities(int count);
+
+    /// @brief Creates entities that are copies of a prefab
+    /// @param prefab Components, default values and groups of the new entities
+    /// @param count Number of copies
+    /// @return New entities, they join their systems in the next Update
+    /// @details Every pool grows once for the whole batch and there is a single log line. When called from a job
+    /// the copies are recorded entity by entity like CreateEntity/AddComponent.
+    std::vector<Entity> Instantiate(const Prefab &prefab, int count);
+
+    /// @brief Makes room for a number of entities, so that creating them does not grow the per-entity storage
+    /// @param count Total number of entities expected
+    void ReserveEntities(int count);
+
+    /// @brief Makes room for a number of components of a type, so that adding them does not reallocate the pool
+    /// @tparam TComponent Component type
+    /// @param count Total number of components expected
+    /// @details Reallocating a pool copies every component and invalidates the references held to them, so
+    /// reserve before loading (not from a job). Pools never shrink, in archetype mode the type is only registered.
+    template<typename TComponent>
+    void Reserve(int count);
+
+    /// @brief Declares a named prefab, replacing the one with the same name
+    /// @return Prefab to be filled
+    Prefab &CreatePrefab(const std::string &name);
+
+    /// @brief Gets a named prefab
+    /// @return Pointer to the prefab, nullptr if no prefab has that name
+    const Prefab *GetPrefab(const std::string &name) const;
+
     void KillEntity(Entity entity);
 
+    /// @brief Checks if a handle refers to a live entity
+    /// @param entity Entity handle to check
+    /// @return true if the handle index exists and its generation is the current one
+    bool IsEntityAlive(Entity entity) const {
+        const auto entityId = static_cast<std::size_t>(entity.GetId());
+        return entityId < entityGenerations.size() && entityGenerations[entityId] == entity.GetGeneration();
+    }
+
+    /// @brief Gets the handle of the entity currently using an index
+    /// @param entityId Entity index
+    /// @return Handle with the current generation of the index
+    Entity GetEntity(int entityId) const {
+        return Entity(entityId, entityGenerations[entityId]);
+    }
+
     // Tag management
+    /// @brief Interns a tag name, the same name always gets the same id
+    /// @param tag Tag name
+    /// @return Id to use with the TagId overloads
+    TagId GetTagId(const std::string &tag);
+
+    /// @brief Gets the name of an interned tag
+    const std::string &GetTagName(TagId tag) const;
+
     void TagEntity(Entity entity, const std::string &tag);
 
+    void TagEntity(Entity entity, TagId tag);
+
     bool EntityHasTag(Entity entity, const std::string &tag) const;
 
+    bool EntityHasTag(Entity entity, TagId tag) const;
+
     Entity GetEntityByTag(const std::string &tag) const;
 
+    Entity GetEntityByTag(TagId tag) const;
+
     void RemoveEntityTag(Entity entity);
 
     // Group management
+    /// @brief Interns a group name, the same name always gets the same id
+    /// @param group Group name
+    /// @return Id to use with the GroupId overloads, INVALID_NAME_ID when MAX_GROUPS groups already exist
+    GroupId GetGroupId(const std::string &group);
+
+    /// @brief Gets the name of an interned group
+    const std::string &GetGroupName(GroupId group) const;
+
     void GroupEntity(Entity entity, const std::string &group);
 
+    void GroupEntity(Entity entity, GroupId group);
+
     bool EntityBelongsToGroup(Entity entity, const std::string &group) const;
 
+    /// @brief Checks if an entity belongs to a group with a single bit test
+    bool EntityBelongsToGroup(Entity entity, GroupId group) const {
+        return group >= 0 && IsEntityAlive(entity) && ((groupsPerEntity[entity.GetId()] >> group) & 1u);
+    }
+
     std::vector<Entity> GetEntitiesByGroup(const std::string &group) const;
 
+    std::vector<Entity> GetEntitiesByGroup(GroupId group) const;
+
+    /// @brief Gets the entities of a group into a vector that uses a custom allocator
+    /// @param allocator Allocator of the vector, e.g. a FrameAllocator for lists that only live one frame
+    template<typename TAllocator>
+    std::vector<Entity, TAllocator> GetEntitiesByGroup(GroupId group, const TAllocator &allocator) const;
+
     void RemoveEntityGroup(Entity entity);
 
     /// @brief Check the component signature of a entity and add the entity to the systems
@@ -351,6 +1146,7 @@ public:
     /// @param entity Entity to be processed
     void AddEntityToSystems(Entity entity);
 
+    /// @brief Removes an entity from every system that currently holds it
     void RemoveEntityFromSystems(Entity entity);
 
     /// @brief Adds a component to an entity
@@ -361,13 +1157,23 @@ public:
     template<typename TComponent, typename... TArgs>
     void AddComponent(Entity entity, TArgs &&... args);
 
+    /// @brief Adds components to many entities at once
+    /// @tparam TComponents Types of the components to add
+    /// @param entities Entities that receive the components
+    /// @param components One vector per component type, element i goes to entities[i]
+    /// @details Every pool reserves its capacity once, each entity moves to its archetype once and its
+    /// signature is updated with a single OR. Components an entity already has are replaced.
+    template<typename... TComponents>
+    void AddComponents(const std::vector<Entity> &entities, std::vector<TComponents>... components);
+
     /// @brief Removes a component from an entity
     /// @tparam TComponent Type of component to be removed from the entity
     /// @param entity Pointer to the entity from which to remove the component
-    /// @details This method updates the entity's component signature by setting the corresponding
-    /// component bit to false, effectively marking that component as no longer present on the entity.
-    /// Note that this only updates the signature and does not actually delete the component data
-    /// from the pool - the data slot is simply marked as available for reuse.
+    /// @details The component is deleted right away: the pool moves its last component into the slot of the
+    /// removed one and pops the back (in archetype mode the entity moves to the archetype without the
+    /// component). This changes the dense order of the pool and invalidates the references and pointers held
+    /// to its components. The signature bit is cleared and the systems drop the entity in the next Update.
+    /// Inside a job the removal is recorded and replayed by Update.
     template<typename TComponent>
     void RemoveComponent(Entity entity);
 
@@ -381,8 +1187,70 @@ public:
     template<typename TComponent>
     bool HasComponent(Entity entity) const;
 
+    /// @brief Gets a component of an entity to read it
+    /// @details The result is read-only: systems such as CollisionSystem and RenderSystem only recompute the
+    /// components stamped as changed, so writes go through GetMutableComponent (or a view + MarkComponentChanged)
     template<typename TComponent>
-    TComponent &GetComponent(Entity entity) const;
+    ComponentConstRef<TComponent> GetComponent(Entity entity) const;
+
+    /// @brief Gets a component of an entity to modify it, stamping it with the current change tick
+    /// @details Only the pool mode tracks changes, in archetype mode every component always counts as changed
+    template<typename TComponent>
+    ComponentRef<TComponent> GetMutableComponent(Entity entity);
+
+    /// @brief Stamps a component of an entity as changed, for writers that went through GetComponent or a view
+    template<typename TComponent>
+    void MarkComponentChanged(Entity entity);
+
+    /// @brief Gets the memory and occupancy of the pools, the systems and the entity ids
+    RegistryStats GetStats() const;
+
+    /// @brief Writes GetStats to a JSON file
+    /// @return false if the file could not be written
+    bool DumpStatsToJson(const std::string &filePath) const;
+
+    /// @brief Gets the current change tick
+    std::uint32_t GetChangeTick() const { return changeTick.load(std::memory_order_relaxed); }
+
+    /// @brief Starts a new change tick
+    /// @return Tick to pass to the next GetEntitiesChangedSince (or Pool::HasChangedSince) call, the changes
+    /// made from now on are newer than it
+    /// @details Call it right after reading the changes, e.g. once per frame in a system
+    std::uint32_t AdvanceChangeTick() { return changeTick.fetch_add(1, std::memory_order_relaxed); }
+
+    /// @brief Gets the entities with a TComponents that was added, replaced or stamped as changed after a tick
+    /// @tparam TComponents Component types to check, an entity is listed once if any of them changed
+    /// @param tick Value returned by an earlier AdvanceChangeTick, 0 for every entity with a TComponents
+    /// @return Entities sorted by id, in archetype mode every entity with a TComponents
+    template<typename... TComponents>
+    std::vector<Entity> GetEntitiesChangedSince(std::uint32_t tick) const;
+
+    /// @brief Gets the pool that stores a component type
+    /// @tparam TComponent Component type
+    /// @return Pointer to the pool, nullptr if no entity ever had the component or in archetype mode
+    template<typename TComponent>
+    Pool<TComponent> *GetComponentPool() const;
+
+    /// @brief Reorders the pool of TComponent so its dense order matches the pool of TOrder, see Pool::AlignTo
+    /// @param owner System that declared OrderComponent<TComponent>, so the scheduler never runs it alongside
+    /// another system that uses the pool
+    /// @return true if every entity of the TOrder pool has its TComponent at the same dense index, false when a
+    /// pool is missing, an entity lacks the component, the owner did not declare the order or in archetype mode
+    template<typename TComponent, typename TOrder>
+    bool AlignComponentPool(const System &owner);
+
+    /// @brief Creates a typed query over every entity that has all the TComponents
+    /// @tparam TComponents Component types an entity must have
+    /// @return View that yields the entity and references to its components
+    template<typename... TComponents>
+    RegistryView<Exclude<>, TComponents...> View();
+
+    /// @brief Creates a typed query over every entity that has all the TComponents and none of the TExcluded
+    /// @tparam TComponents Component types an entity must have
+    /// @tparam TExcluded Component types an entity must not have
+    /// @return View that yields the entity and references to its components
+    template<typename... TComponents, typename... TExcluded>
+    RegistryView<Exclude<TExcluded...>, TComponents...> View(Exclude<TExcluded...>);
 
     template<typename TSystem, typename... TArgs>
     void AddSystem(TArgs &&... args);
@@ -396,8 +1264,239 @@ public:
     template<typename TSystem>
     TSystem &GetSystem() const;
 
-    // TODO: Implement the following methods:
-    // - KillEntity: Remove an entity from the system
+    /// @brief Schedules the update of a system for the next RunScheduledSystems
+    /// @tparam TSystem Type of the system to update
+    /// @param update Function called with the system, it may run on a worker thread
+    /// @details Only systems that declare their component access run on worker threads, their structural
+    /// changes are recorded in command buffers and applied in the next Update
+    template<typename TSystem, typename TUpdate>
+    void ScheduleSystem(TUpdate update);
+
+    /// @brief Calls a function for every entity of a system, splitting the entities in jobs
+    /// @param system System whose entities are processed
+    /// @param chunkSize Number of entities per job
+    /// @param function Called as function(Entity) from several threads at once, structural changes
+    /// (CreateEntity, Kill, Add/RemoveComponent) are recorded and applied in the next Update
+    template<typename TFunction>
+    void ParallelForEach(const System &system, int chunkSize, const TFunction &function);
+
+    /// @brief Splits the range [0, count) in jobs, for systems that loop over component arrays directly
+    /// @param count Number of items
+    /// @param chunkSize Number of items per job
+    /// @param function Called as function(begin, end) from several threads at once, structural changes are
+    /// recorded like in ParallelForEach
+    template<typename TFunction>
+    void ParallelFor(int count, int chunkSize, const TFunction &function) {
+        jobSystem->ParallelFor(count, chunkSize, function);
+    }
+
+    /// @brief Runs the scheduled system updates, non-conflicting systems in parallel
+    /// @details Systems run in the order they were scheduled unless their component access does not conflict
+    void RunScheduledSystems();
+
+    template<typename TExclude, typename... TComponents>
+    friend class RegistryView;
+};
+
+/// @brief Typed query over all entities that have every component in TComponents and none in TExcluded
+/// In pool mode the iteration is driven by the smallest pool among TComponents and the other components
+/// are fetched by direct sparse-set indexing. In archetype mode it walks the chunks of every matching
+/// archetype. Entities can be killed or created while iterating (both are deferred), but components of the
+/// viewed types must not be added or removed until the iteration ends.
+/// @tparam TExcluded Component types an entity must not have
+/// @tparam TComponents Component types an entity must have
+template<typename... TExcluded, typename... TComponents>
+class RegistryView<Exclude<TExcluded...>, TComponents...> {
+private:
+    Registry *registry;
+    Signature includeSignature;
+    Signature excludeSignature;
+
+    // Pool mode: component pools and the packed entity ids of the smallest one
+    std::tuple<Pool<TComponents> *...> pools;
+    // When only empty components are viewed there is no pool to drive from and every entity index is a candidate
+    const int *driverEntityIds = nullptr;
+    int driverSize = 0;
+
+    // Archetype mode: archetypes whose signature matches the query
+    std::vector<const Archetype *> archetypes;
+
+    bool Matches(int entityId) const {
+        const Signature &signature = registry->entityComponentSignatures[entityId];
+        return signature.Contains(includeSignature) && !signature.Intersects(excludeSignature);
+    }
+
+    Entity MakeEntity(int entityId) const {
+        return Entity(entityId, registry->entityGenerations[entityId]);
+    }
+
+    int DriverEntityId(int index) const {
+        return driverEntityIds ? driverEntityIds[index] : index;
+    }
+
+    template<typename TComponent>
+    static ComponentRef<TComponent> GetFromPool(Pool<TComponent> *pool, int entityId) {
+        if constexpr (IsEmptyComponent<TComponent>) {
+            return GetEmptyComponent<TComponent>();
+        } else {
+            return pool->Get(entityId);
+        }
+    }
+
+    template<typename TComponent>
+    static TComponent *GetColumn(const Archetype *archetype, int chunk) {
+        if constexpr (IsEmptyComponent<TComponent>) {
+            return &GetEmptyComponent<TComponent>();
+        } else {
+            return static_cast<TComponent *>(archetype->GetColumn(chunk, Component<TComponent>::GetId()));
+        }
+    }
+
+    template<typename TComponent>
+    static ComponentRef<TComponent> ColumnAt(TComponent *column, int row) {
+        if constexpr (IsEmptyComponent<TComponent>) {
+            return *column;
+        } else {
+            return MakeComponentRef(column[row]);
+        }
+    }
+
+public:
+    explicit RegistryView(Registry *registry) : registry(registry) {
+        (includeSignature.set(Component<TComponents>::GetId()), ...);
+        (excludeSignature.set(Component<TExcluded>::GetId()), ...);
+
+        if (registry->GetStorageMode() == StorageMode::Archetypes) {
+            for (const auto &archetype: registry->archetypeStorage->GetArchetypes()) {
+                const Signature &signature = archetype->GetSignature();
+                if (signature.Contains(includeSignature) && !signature.Intersects(excludeSignature)) {
+                    archetypes.push_back(archetype.get());
+                }
+            }
+            return;
+        }
+
+        pools = std::make_tuple(registry->GetComponentPool<TComponents>()...);
+        const bool hasAllPools = ((IsEmptyComponent<TComponents> || std::get<Pool<TComponents> *>(pools) != nullptr) && ...);
+        if (!hasAllPools) {
+            return;
+        }
+
+        // Drive the iteration from the smallest participating pool
+        driverSize = -1;
+        auto pickSmallest = [this](auto *pool) {
+            if (pool && (driverSize < 0 || pool->GetSize() < driverSize)) {
+                driverSize = pool->GetSize();
+                driverEntityIds = pool->GetEntityIds();
+            }
+        };
+        (pickSmallest(std::get<Pool<TComponents> *>(pools)), ...);
+
+        if (driverSize < 0) {
+            driverSize = static_cast<int>(registry->entityComponentSignatures.size());
+        }
+    }
+
+    /// @brief Invokes a function for every matching entity
+    /// @param func Callable with the signature void(Entity, ComponentRef<TComponents>...)
+    template<typename TFunc>
+    void Each(TFunc &&func) const {
+        if (registry->GetStorageMode() == StorageMode::Archetypes) {
+            for (const Archetype *archetype: archetypes) {
+                for (int chunk = 0; chunk < archetype->GetChunkCount(); chunk++) {
+                    const int *entityIds = archetype->GetEntityIds(chunk);
+                    const int count = archetype->GetChunkCount(chunk);
+                    auto columns = std::make_tuple(GetColumn<TComponents>(archetype, chunk)...);
+                    for (int row = 0; row < count; row++) {
+                        func(MakeEntity(entityIds[row]), ColumnAt(std::get<TComponents *>(columns), row)...);
+                    }
+                }
+            }
+            return;
+        }
+
+        for (int i = 0; i < driverSize; i++) {
+            const int entityId = DriverEntityId(i);
+            if (Matches(entityId)) {
+                func(MakeEntity(entityId), GetFromPool(std::get<Pool<TComponents> *>(pools), entityId)...);
+            }
+        }
+    }
+
+    /// @brief Forward iterator that yields a tuple with the entity and ComponentRefs to its components
+    class Iterator {
+    private:
+        const RegistryView *view;
+        std::size_t archetypeIndex;
+        int chunk;
+        int index;
+
+        bool IsArchetypeMode() const {
+            return view->registry->GetStorageMode() == StorageMode::Archetypes;
+        }
+
+        /// @brief Moves forward until the iterator points to a matching entity or to the end
+        void SkipToValid() {
+            if (IsArchetypeMode()) {
+                while (archetypeIndex < view->archetypes.size()) {
+                    const Archetype *archetype = view->archetypes[archetypeIndex];
+                    if (chunk < archetype->GetChunkCount() && index < archetype->GetChunkCount(chunk)) {
+                        return;
+                    }
+                    if (chunk < archetype->GetChunkCount() - 1) {
+                        chunk++;
+                    } else {
+                        archetypeIndex++;
+                        chunk = 0;
+                    }
+                    index = 0;
+                }
+                return;
+            }
+
+            while (index < view->driverSize && !view->Matches(view->DriverEntityId(index))) {
+                index++;
+            }
+        }
+
+    public:
+        Iterator(const RegistryView *view, bool isEnd) : view(view), archetypeIndex(0), chunk(0), index(0) {
+            if (isEnd) {
+                archetypeIndex = view->archetypes.size();
+                index = IsArchetypeMode() ? 0 : view->driverSize;
+            } else {
+                SkipToValid();
+            }
+        }
+
+        std::tuple<Entity, ComponentRef<TComponents>...> operator*() const {
+            if (IsArchetypeMode()) {
+                const Archetype *archetype = view->archetypes[archetypeIndex];
+                return std::tuple<Entity, ComponentRef<TComponents>...>(
+                    view->MakeEntity(archetype->GetEntityIds(chunk)[index]),
+                    ColumnAt(GetColumn<TComponents>(archetype, chunk), index)...);
+            }
+            const int entityId = view->DriverEntityId(index);
+            return std::tuple<Entity, ComponentRef<TComponents>...>(
+                view->MakeEntity(entityId), GetFromPool(std::get<Pool<TComponents> *>(view->pools), entityId)...);
+        }
+
+        Iterator &operator++() {
+            index++;
+            SkipToValid();
+            return *this;
+        }
+
+        bool operator==(const Iterator &other) const {
+            return archetypeIndex == other.archetypeIndex && chunk == other.chunk && index == other.index;
+        }
+
+        bool operator!=(const Iterator &other) const { return !(*this == other); }
+    };
+
+    Iterator begin() const { return Iterator(this, false); }
+
+    Iterator end() const { return Iterator(this, true); }
 };
 
 /// @brief Implementation of the RequireComponent method
@@ -409,6 +1508,29 @@ void System::RequireComponent() {
     componentSignature.set(componentId);
 }
 
+template<typename TComponent>
+void System::ReadComponent() {
+    componentReads.set(Component<TComponent>::GetId());
+    declaresComponentAccess = true;
+}
+
+template<typename TComponent>
+void System::WriteComponent() {
+    componentWrites.set(Component<TComponent>::GetId());
+    declaresComponentAccess = true;
+}
+
+template<typename TComponent>
+void System::OrderComponent() {
+    componentOrders.set(Component<TComponent>::GetId());
+    WriteComponent<TComponent>();
+}
+
+template<typename TComponent>
+bool System::OrdersComponent() const {
+    return componentOrders.test(Component<TComponent>::GetId());
+}
+
 /// @brief Implementation of AddComponent method
 /// Adds a component of type TComponent to the specified entity
 /// @tparam TComponent Type of component to add
@@ -417,29 +1539,62 @@ void System::RequireComponent() {
 /// @param args Arguments for component construction
 template<typename TComponent, typename... TArgs>
 void Registry::AddComponent(Entity entity, TArgs &&... args) {
+    if (CommandBuffer *commandBuffer = GetCommandBuffer()) {
+        commandBuffer->commands.emplace_back(
+            [this, entity, component = TComponent(std::forward<TArgs>(args)...)]() mutable {
+                AddComponent<TComponent>(entity, std::move(component));
+            });
+        return;
+    }
+
     const auto componentId = Component<TComponent>::GetId();
     const auto entityId = entity.GetId();
 
-    // Resize component pools if necessary
-    if ((long unsigned int) componentId >= componentPools.size()) {
-        componentPools.resize(componentId + 1, nullptr);
+    if (storageMode == StorageMode::Archetypes && !archetypeStorage->IsComponentTypeRegistered(componentId)) {
+        archetypeStorage->RegisterComponentType(componentId, MakeComponentTypeInfo<TComponent>());
     }
 
-    // Create new pool for this component type if it doesn't exist
-    if (!componentPools[componentId]) {
-        std::shared_ptr<Pool<TComponent> > newComponentPool = std::make_shared<Pool<TComponent> >();
-        componentPools[componentId] = newComponentPool;
+    // Empty (tag) components only set the signature bit, in archetype mode the entity still moves to the
+    // archetype of its new signature but no column is stored
+    if constexpr (IsEmptyComponent<TComponent>) {
+        if (!entityComponentSignatures[entityId].test(componentId)) {
+            if (storageMode == StorageMode::Archetypes) {
+                archetypeStorage->AddComponent(entityId, componentId);
+            }
+            entityComponentSignatures[entityId].set(componentId);
+            MarkEntityForRematch(entity);
+        }
+
+        Logger::Log(
+            "Component id = " + std::to_string(componentId) + " was added to entity id " + std::to_string(entityId));
+        return;
     }
 
-    std::shared_ptr<Pool<TComponent> > componentPool = std::static_pointer_cast<Pool<TComponent> >(
-        componentPools[componentId]);
+    if (storageMode == StorageMode::Archetypes) {
+        if (entityComponentSignatures[entityId].test(componentId)) {
+            *static_cast<TComponent *>(archetypeStorage->Get(entityId, componentId)) =
+                    TComponent(std::forward<TArgs>(args)...);
+        } else {
+            new(archetypeStorage->AddComponent(entityId, componentId)) TComponent(std::forward<TArgs>(args)...);
+            entityComponentSignatures[entityId].set(componentId);
+            MarkEntityForRematch(entity);
+        }
+
+        Logger::Log(
+            "Component id = " + std::to_string(componentId) + " was added to entity id " + std::to_string(entityId));
+        return;
+    }
 
-    // Create and add the new component
-    TComponent newComponent(std::forward<TArgs>(args)...);
-    componentPool->Set(entityId, newComponent);
+    Pool<TComponent> *componentPool = GetOrCreateComponentPool<TComponent>();
 
-    // Update the entity's component signature
-    entityComponentSignatures[entityId].set(componentId);
+    // Construct the new component in place inside the pool
+    componentPool->Emplace(entityId, std::forward<TArgs>(args)...);
+
+    // Update the entity's component signature, the systems pick the change up in the next Update
+    if (!entityComponentSignatures[entityId].test(componentId)) {
+        entityComponentSignatures[entityId].set(componentId);
+        MarkEntityForRematch(entity);
+    }
 
     Logger::Log(
         "Component id = " + std::to_string(componentId) + " was added to entity id " + std::to_string(entityId));
@@ -455,17 +1610,32 @@ void Registry::AddComponent(Entity entity, TArgs &&... args) {
 /// @param entity Pointer to the entity from which to remove the component
 template<typename TComponent>
 void Registry::RemoveComponent(Entity entity) {
+    if (CommandBuffer *commandBuffer = GetCommandBuffer()) {
+        commandBuffer->commands.emplace_back([this, entity]() { RemoveComponent<TComponent>(entity); });
+        return;
+    }
+
     const auto componentId = Component<TComponent>::GetId();
     const auto entityId = entity.GetId();
 
-    std::shared_ptr<Pool<TComponent> > componentPool = std::static_pointer_cast<Pool<TComponent> >(
-        componentPools[componentId]);
-    componentPool->Remove(entityId);
+    if (!entityComponentSignatures[entityId].test(componentId)) {
+        return;
+    }
+
+    if (storageMode == StorageMode::Archetypes) {
+        archetypeStorage->RemoveComponent(entityId, componentId);
+    } else if constexpr (!IsEmptyComponent<TComponent>) {
+        std::shared_ptr<Pool<TComponent> > componentPool = std::static_pointer_cast<Pool<TComponent> >(
+            componentPools[componentId]);
+        componentPool->Remove(entityId);
+    }
 
     // Update the entity's signature to indicate it no longer has this component
     // The second parameter 'false' explicitly sets the bit to 0
     entityComponentSignatures[entityId].set(componentId, false);
 
+    // The systems that required the component drop the entity in the next Update
+    MarkEntityForRematch(entity);
 
     Logger::Log(
         "Component id = " + std::to_string(componentId) + " was removed from entity id " + std::to_string(entityId));
@@ -485,16 +1655,278 @@ bool Registry::HasComponent(Entity entity) const {
 }
 
 template<typename TComponent>
-TComponent &Registry::GetComponent(Entity entity) const {
+ComponentConstRef<TComponent> Registry::GetComponent(Entity entity) const {
     const auto componentId = Component<TComponent>::GetId();
 
     const auto entityId = entity.GetId();
 
-    auto componentPool = std::static_pointer_cast<Pool<TComponent> >(componentPools[componentId]);
+    if constexpr (IsEmptyComponent<TComponent>) {
+        return GetEmptyComponent<TComponent>();
+    }
+
+    if (storageMode == StorageMode::Archetypes) {
+        return *static_cast<const TComponent *>(archetypeStorage->Get(entityId, componentId));
+    }
+
+    // Avoid copying the shared_ptr, this is called for every component of every entity each frame
+    auto componentPool = static_cast<Pool<TComponent> *>(componentPools[componentId].get());
 
     return componentPool->Get(entityId);
 }
 
+template<typename TComponent>
+ComponentRef<TComponent> Registry::GetMutableComponent(Entity entity) {
+    const auto entityId = entity.GetId();
+
+    if constexpr (IsEmptyComponent<TComponent>) {
+        return GetEmptyComponent<TComponent>();
+    } else {
+        if (storageMode == StorageMode::Archetypes) {
+            return MakeComponentRef(
+                *static_cast<TComponent *>(archetypeStorage->Get(entityId, Component<TComponent>::GetId())));
+        }
+        return GetComponentPool<TComponent>()->GetMutable(entityId);
+    }
+}
+
+template<typename TComponent>
+void Registry::MarkComponentChanged(Entity entity) {
+    if constexpr (!IsEmptyComponent<TComponent>) {
+        if (storageMode == StorageMode::Pools) {
+            GetComponentPool<TComponent>()->MarkChanged(entity.GetId());
+        }
+    }
+}
+
+template<typename... TComponents>
+std::vector<Entity> Registry::GetEntitiesChangedSince(std::uint32_t tick) const {
+    std::vector<int> entityIds;
+
+    if (storageMode == StorageMode::Archetypes) {
+        Signature signature;
+        (signature.set(Component<TComponents>::GetId()), ...);
+        // Ids reserved by jobs have no storage until the next Update, so only the stored entities are listed
+        const int numStoredEntities = static_cast<int>(entityComponentSignatures.size());
+        for (int entityId = 0; entityId < numStoredEntities; entityId++) {
+            if (entityComponentSignatures[entityId].Intersects(signature)) {
+                entityIds.push_back(entityId);
+            }
+        }
+    } else {
+        auto collectChanged = [&entityIds, tick](const auto *pool) {
+            if (!pool || !pool->HasChangedSince(tick)) {
+                return;
+            }
+            for (int i = 0; i < pool->GetSize(); i++) {
+                if (pool->GetVersion(i) > tick) {
+                    entityIds.push_back(pool->GetEntityId(i));
+                }
+            }
+        };
+        (collectChanged(GetComponentPool<TComponents>()), ...);
+
+        std::sort(entityIds.begin(), entityIds.end());
+        entityIds.erase(std::unique(entityIds.begin(), entityIds.end()), entityIds.end());
+    }
+
+    std::vector<Entity> entities;
+    entities.reserve(entityIds.size());
+    for (auto entityId: entityIds) {
+        entities.emplace_back(entityId, entityGenerations[entityId]);
+    }
+    return entities;
+}
+
+/// @brief Implementation of GetComponentPool
+/// @tparam TComponent Component type
+/// @return Pointer to the pool or nullptr if it does not exist
+template<typename TComponent>
+Pool<TComponent> *Registry::GetComponentPool() const {
+    const auto componentId = Component<TComponent>::GetId();
+    if (static_cast<std::size_t>(componentId) >= componentPools.size()) {
+        return nullptr;
+    }
+    return static_cast<Pool<TComponent> *>(componentPools[componentId].get());
+}
+
+template<typename TComponent, typename TOrder>
+bool Registry::AlignComponentPool(const System &owner) {
+    if (!owner.OrdersComponent<TComponent>()) {
+        Logger::Err("AlignComponentPool: the system did not declare OrderComponent for " +
+                    GetTypeName(typeid(TComponent).name()));
+        return false;
+    }
+    auto *pool = GetComponentPool<TComponent>();
+    auto *orderPool = GetComponentPool<TOrder>();
+    if (!pool || !orderPool) {
+        return false;
+    }
+    return pool->AlignTo(orderPool->GetEntityIds(), orderPool->GetSize());
+}
+
+template<typename TComponent>
+Pool<TComponent> *Registry::GetOrCreateComponentPool() {
+    const auto componentId = Component<TComponent>::GetId();
+
+    // Resize component pools if necessary
+    if ((long unsigned int) componentId >= componentPools.size()) {
+        componentPools.resize(componentId + 1, nullptr);
+    }
+
+    // Create new pool for this component type if it doesn't exist
+    if (!componentPools[componentId]) {
+        std::shared_ptr<Pool<TComponent> > newComponentPool = std::make_shared<Pool<TComponent> >(100, &changeTick);
+        componentPools[componentId] = newComponentPool;
+    }
+
+    return static_cast<Pool<TComponent> *>(componentPools[componentId].get());
+}
+
+template<typename TComponent>
+void Registry::ReserveComponentCopies(int count) {
+    const auto componentId = Component<TComponent>::GetId();
+
+    if (storageMode == StorageMode::Archetypes) {
+        if (!archetypeStorage->IsComponentTypeRegistered(componentId)) {
+            archetypeStorage->RegisterComponentType(componentId, MakeComponentTypeInfo<TComponent>());
+        }
+        return;
+    }
+
+    if constexpr (!IsEmptyComponent<TComponent>) {
+        Pool<TComponent> *componentPool = GetOrCreateComponentPool<TComponent>();
+        const int requiredCapacity = componentPool->GetSize() + count;
+        if (requiredCapacity > componentPool->GetCapacity()) {
+            componentPool->Reserve(std::max(requiredCapacity, componentPool->GetCapacity() * 2));
+        }
+    }
+}
+
+template<typename TComponent>
+void Registry::Reserve(int count) {
+    if (storageMode == StorageMode::Archetypes) {
+        const auto componentId = Component<TComponent>::GetId();
+        if (!archetypeStorage->IsComponentTypeRegistered(componentId)) {
+            archetypeStorage->RegisterComponentType(componentId, MakeComponentTypeInfo<TComponent>());
+        }
+        return;
+    }
+
+    if constexpr (!IsEmptyComponent<TComponent>) {
+        GetOrCreateComponentPool<TComponent>()->Reserve(count);
+    }
+}
+
+template<typename TComponent>
+void Registry::ConstructComponentCopy(int entityId, const TComponent &value) {
+    if constexpr (!IsEmptyComponent<TComponent>) {
+        const auto componentId = Component<TComponent>::GetId();
+        if (storageMode == StorageMode::Archetypes) {
+            new(archetypeStorage->Get(entityId, componentId)) TComponent(value);
+        } else {
+            static_cast<Pool<TComponent> *>(componentPools[componentId].get())->Emplace(entityId, value);
+        }
+    }
+}
+
+template<typename TComponent>
+void Registry::StoreComponent(int entityId, bool hadComponent, TComponent &&component) {
+    if constexpr (!IsEmptyComponent<TComponent>) {
+        const auto componentId = Component<TComponent>::GetId();
+        if (storageMode == StorageMode::Archetypes) {
+            void *cell = archetypeStorage->Get(entityId, componentId);
+            if (hadComponent) {
+                *static_cast<TComponent *>(cell) = std::move(component);
+            } else {
+                new(cell) TComponent(std::move(component));
+            }
+        } else {
+            static_cast<Pool<TComponent> *>(componentPools[componentId].get())->Emplace(entityId, std::move(component));
+        }
+    }
+}
+
+template<typename... TComponents>
+void Registry::AddComponents(const std::vector<Entity> &entities, std::vector<TComponents>... components) {
+    if (((components.size() != entities.size()) || ...)) {
+        Logger::Err("AddComponents needs one component of each type per entity");
+        return;
+    }
+
+    // Inside jobs every component is recorded on its own
+    if (GetCommandBuffer()) {
+        for (std::size_t i = 0; i < entities.size(); i++) {
+            (AddComponent<TComponents>(entities[i], std::move(components[i])), ...);
+        }
+        return;
+    }
+
+    Signature addedSignature;
+    (addedSignature.set(Component<TComponents>::GetId()), ...);
+    (ReserveComponentCopies<TComponents>(static_cast<int>(entities.size())), ...);
+
+    for (std::size_t i = 0; i < entities.size(); i++) {
+        const int entityId = entities[i].GetId();
+        const Signature oldSignature = entityComponentSignatures[entityId];
+        const Signature newSignature = oldSignature | addedSignature;
+
+        if (storageMode == StorageMode::Archetypes && newSignature != oldSignature) {
+            archetypeStorage->AddComponents(entityId, newSignature);
+        }
+        (StoreComponent<TComponents>(entityId, oldSignature.test(Component<TComponents>::GetId()),
+                                     std::move(components[i])), ...);
+
+        if (newSignature != oldSignature) {
+            entityComponentSignatures[entityId] = newSignature;
+            MarkEntityForRematch(entities[i]);
+        }
+    }
+
+    Logger::Log("Added " + std::to_string(sizeof...(TComponents)) + " component types to " +
+                std::to_string(entities.size()) + " entities");
+}
+
+template<typename TComponent>
+void Prefab::PrefabComponent<TComponent>::Reserve(Registry &registry, int count) const {
+    registry.ReserveComponentCopies<TComponent>(count);
+}
+
+template<typename TComponent>
+void Prefab::PrefabComponent<TComponent>::Construct(Registry &registry, int entityId) const {
+    registry.ConstructComponentCopy<TComponent>(entityId, value);
+}
+
+template<typename TComponent>
+void Prefab::PrefabComponent<TComponent>::AddTo(Entity entity) const {
+    entity.AddComponent<TComponent>(value);
+}
+
+template<typename TAllocator>
+std::vector<Entity, TAllocator> Registry::GetEntitiesByGroup(GroupId group, const TAllocator &allocator) const {
+    std::vector<Entity, TAllocator> entities(allocator);
+    if (group < 0) {
+        return entities;
+    }
+
+    const std::uint64_t groupMask = std::uint64_t(1) << group;
+    for (std::size_t entityId = 0; entityId < groupsPerEntity.size(); entityId++) {
+        if (groupsPerEntity[entityId] & groupMask) {
+            entities.push_back(GetEntity(static_cast<int>(entityId)));
+        }
+    }
+    return entities;
+}
+
+template<typename... TComponents>
+RegistryView<Exclude<>, TComponents...> Registry::View() {
+    return RegistryView<Exclude<>, TComponents...>(this);
+}
+
+template<typename... TComponents, typename... TExcluded>
+RegistryView<Exclude<TExcluded...>, TComponents...> Registry::View(Exclude<TExcluded...>) {
+    return RegistryView<Exclude<TExcluded...>, TComponents...>(this);
+}
+
 /// @brief Adds a system to the registry
 /// @tparam TSystem Type of system to add
 /// @tparam TArgs System constructor argument types
@@ -535,6 +1967,22 @@ TSystem &Registry::GetSystem() const {
     return *(std::static_pointer_cast<TSystem>(system->second));
 }
 
+template<typename TSystem, typename TUpdate>
+void Registry::ScheduleSystem(TUpdate update) {
+    TSystem &system = GetSystem<TSystem>();
+    systemScheduler->Schedule(system, [&system, update]() { update(system); });
+}
+
+template<typename TFunction>
+void Registry::ParallelForEach(const System &system, int chunkSize, const TFunction &function) {
+    const EntityView entities = system.GetSystemEntities();
+    jobSystem->ParallelFor(static_cast<int>(entities.size()), chunkSize, [&entities, &function](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            function(entities[i]);
+        }
+    });
+}
+
 /// @brief Implementation of component addition
 /// Delegates component addition to the registry
 template<typename TComponent, typename... TArgs>
@@ -559,8 +2007,15 @@ bool Entity::HasComponent() const {
 /// @brief Implementation of component retrieval
 /// Delegates component retrieval to the registry
 template<typename TComponent>
-TComponent &Entity::GetComponent() const {
+ComponentConstRef<TComponent> Entity::GetComponent() const {
     return registry->GetComponent<TComponent>(*this);
 }
 
+/// @brief Implementation of mutable component retrieval
+/// Delegates component retrieval to the registry
+template<typename TComponent>
+ComponentRef<TComponent> Entity::GetMutableComponent() const {
+    return registry->GetMutableComponent<TComponent>(*this);
+}
+
 #endif /** ECS_H */
@@ -0,0 +1,130 @@
+#ifndef SIGNATURE_H
+#define SIGNATURE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/// @brief Compile-time component capacity, override with -DECS_MAX_COMPONENTS=128 (or 256)
+#ifndef ECS_MAX_COMPONENTS
+#define ECS_MAX_COMPONENTS 64
+#endif
+
+static_assert(ECS_MAX_COMPONENTS == 64 || ECS_MAX_COMPONENTS == 128 || ECS_MAX_COMPONENTS == 256,
+              "ECS_MAX_COMPONENTS must be 64, 128 or 256");
+
+/// @brief Constant defining the maximum number of supported components
+const unsigned int MAX_COMPONENTS = ECS_MAX_COMPONENTS;
+
+/// @brief Signature, we use a bitset (1s and 0s) to keep track of which components an entity has,
+/// and also helps keep track of which entities a system is interested in.
+/// The bits are stored in aligned 64-bit words and every operation is a fixed-length loop over them, so with
+/// 64 components a match is a single AND/compare and with 128/256 components the compiler emits one SSE2/AVX2
+/// operation per test.
+class Signature {
+public:
+    static const std::size_t NUM_WORDS = MAX_COMPONENTS / 64;
+
+private:
+    alignas(MAX_COMPONENTS / 8 > 32 ? 32 : MAX_COMPONENTS / 8) std::uint64_t words[NUM_WORDS] = {};
+
+public:
+    std::size_t size() const { return MAX_COMPONENTS; }
+
+    bool test(std::size_t bit) const {
+        assert(bit < MAX_COMPONENTS);
+        return (words[bit / 64] >> (bit % 64)) & 1u;
+    }
+
+    Signature &set(std::size_t bit, bool value = true) {
+        assert(bit < MAX_COMPONENTS);
+        const std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+        words[bit / 64] = value ? (words[bit / 64] | mask) : (words[bit / 64] & ~mask);
+        return *this;
+    }
+
+    Signature &reset(std::size_t bit) {
+        return set(bit, false);
+    }
+
+    Signature &reset() {
+        for (std::size_t i = 0; i < NUM_WORDS; i++) {
+            words[i] = 0;
+        }
+        return *this;
+    }
+
+    bool any() const {
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < NUM_WORDS; i++) {
+            bits |= words[i];
+        }
+        return bits != 0;
+    }
+
+    bool none() const { return !any(); }
+
+    /// @brief Checks if every bit of another signature is also set in this one
+    /// @param required Signature with the required bits, e.g. the signature of a system
+    /// @return true if (*this & required) == required
+    bool Contains(const Signature &required) const {
+        std::uint64_t missing = 0;
+        for (std::size_t i = 0; i < NUM_WORDS; i++) {
+            missing |= required.words[i] & ~words[i];
+        }
+        return missing == 0;
+    }
+
+    /// @brief Checks if the two signatures have a bit in common
+    bool Intersects(const Signature &other) const {
+        std::uint64_t common = 0;
+        for (std::size_t i = 0; i < NUM_WORDS; i++) {
+            common |= words[i] & other.words[i];
+        }
+        return common != 0;
+    }
+
+    Signature operator&(const Signature &other) const {
+        Signature result;
+        for (std::size_t i = 0; i < NUM_WORDS; i++) {
+            result.words[i] = words[i] & other.words[i];
+        }
+        return result;
+    }
+
+    Signature operator|(const Signature &other) const {
+        Signature result;
+        for (std::size_t i = 0; i < NUM_WORDS; i++) {
+            result.words[i] = words[i] | other.words[i];
+        }
+        return result;
+    }
+
+    bool operator==(const Signature &other) const {
+        std::uint64_t difference = 0;
+        for (std::size_t i = 0; i < NUM_WORDS; i++) {
+            difference |= words[i] ^ other.words[i];
+        }
+        return difference == 0;
+    }
+
+    bool operator!=(const Signature &other) const { return !(*this == other); }
+
+    std::size_t Hash() const {
+        std::size_t hash = 0;
+        for (std::size_t i = 0; i < NUM_WORDS; i++) {
+            hash ^= std::hash<std::uint64_t>()(words[i]) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+namespace std {
+    template<>
+    struct hash<Signature> {
+        std::size_t operator()(const Signature &signature) const { return signature.Hash(); }
+    };
+}
+
+#endif /** SIGNATURE_H */
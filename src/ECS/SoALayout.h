@@ -0,0 +1,160 @@
+#ifndef SOALAYOUT_H
+#define SOALAYOUT_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/// @brief Component types opt into structure-of-arrays (SoA) storage in their pool by specializing this trait
+/// next to the component (see TransformComponent.h). A specialization provides:
+///  - Columns: struct with one std::vector per scalar field
+///  - Reference: proxy returned instead of TComponent & by GetMutableComponent and the views. It aliases one
+///    slot and is assignable from and convertible to TComponent
+///  - ForEachColumn(columns, function): calls function(column) for every column (columns may be const)
+///  - At(columns, index): Reference to a slot of the columns
+///  - Bind(component): Reference to a TComponent object, used by the archetype storage that stays AoS
+template<typename TComponent>
+struct SoALayout {
+    static constexpr bool isEnabled = false;
+};
+
+template<typename TComponent>
+constexpr bool IsSoAComponent = SoALayout<TComponent>::isEnabled;
+
+template<typename TComponent, bool = IsSoAComponent<TComponent> >
+struct ComponentRefType {
+    typedef TComponent &Type;
+};
+
+template<typename TComponent>
+struct ComponentRefType<TComponent, true> {
+    typedef typename SoALayout<TComponent>::Reference Type;
+};
+
+/// @brief What accessing a stored component returns: TComponent & or the Reference proxy of SoA components
+/// Bind it with auto && to work with both: auto copies ordinary components (writes are lost) and auto & does
+/// not bind the proxy. Copy it into a TComponent to keep a snapshot.
+template<typename TComponent>
+using ComponentRef = typename ComponentRefType<TComponent>::Type;
+
+template<typename TComponent, bool = IsSoAComponent<TComponent> >
+struct ComponentConstRefType {
+    typedef const TComponent &Type;
+};
+
+template<typename TComponent>
+struct ComponentConstRefType<TComponent, true> {
+    typedef const TComponent Type;
+};
+
+/// @brief What reading a stored component returns: const TComponent & or a const copy of SoA components
+/// Writing through it does not compile, so every write goes through a ComponentRef that stamps the change.
+template<typename TComponent>
+using ComponentConstRef = typename ComponentConstRefType<TComponent>::Type;
+
+/// @brief Gets the ComponentRef of a component object
+template<typename TComponent>
+ComponentRef<TComponent> MakeComponentRef(TComponent &component) {
+    if constexpr (IsSoAComponent<TComponent>) {
+        return SoALayout<TComponent>::Bind(component);
+    } else {
+        return component;
+    }
+}
+
+/// @brief Proxy of a glm::vec2 whose x and y live in separate arrays
+/// Copies alias the same floats, assignments write the values.
+struct Vec2Ref {
+    float &x;
+    float &y;
+
+    Vec2Ref(float &x, float &y) : x(x), y(y) {}
+
+    Vec2Ref(const Vec2Ref &) = default;
+
+    Vec2Ref &operator=(const Vec2Ref &other) {
+        x = other.x;
+        y = other.y;
+        return *this;
+    }
+
+    Vec2Ref &operator=(const glm::vec2 &value) {
+        x = value.x;
+        y = value.y;
+        return *this;
+    }
+
+    Vec2Ref &operator+=(const glm::vec2 &value) {
+        x += value.x;
+        y += value.y;
+        return *this;
+    }
+
+    Vec2Ref &operator-=(const glm::vec2 &value) {
+        x -= value.x;
+        y -= value.y;
+        return *this;
+    }
+
+    operator glm::vec2() const { return glm::vec2(x, y); }
+};
+
+/// @brief Packed component storage of a pool for SoA components, with the interface of std::vector it uses
+template<typename TComponent>
+class SoAArray {
+private:
+    typedef SoALayout<TComponent> Layout;
+
+    typename Layout::Columns columns;
+    std::size_t count = 0;
+
+public:
+    typedef typename Layout::Reference Reference;
+
+    bool empty() const { return count == 0; }
+
+    std::size_t size() const { return count; }
+
+    /// @brief Gets the number of components the columns can hold without reallocating
+    std::size_t capacity() const {
+        std::size_t result = static_cast<std::size_t>(-1);
+        Layout::ForEachColumn(columns, [&result](auto &column) { result = std::min(result, column.capacity()); });
+        return result;
+    }
+
+    void reserve(std::size_t n) {
+        Layout::ForEachColumn(columns, [n](auto &column) { column.reserve(n); });
+    }
+
+    void clear() {
+        Layout::ForEachColumn(columns, [](auto &column) { column.clear(); });
+        count = 0;
+    }
+
+    template<typename... TArgs>
+    Reference emplace_back(TArgs &&... args) {
+        Layout::ForEachColumn(columns, [](auto &column) { column.emplace_back(); });
+        Reference slot = Layout::At(columns, count++);
+        slot = TComponent(std::forward<TArgs>(args)...);
+        return slot;
+    }
+
+    void pop_back() {
+        Layout::ForEachColumn(columns, [](auto &column) { column.pop_back(); });
+        count--;
+    }
+
+    Reference operator[](std::size_t index) {
+        return Layout::At(columns, index);
+    }
+
+    /// @brief Gets the field arrays, for loops that process one field of many components at once
+    typename Layout::Columns &GetColumns() {
+        return columns;
+    }
+};
+
+#endif /** SOALAYOUT_H */
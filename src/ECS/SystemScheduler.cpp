@@ -0,0 +1,98 @@
+#include "SystemScheduler.h"
+#include "ECS.h"
+
+void SystemScheduler::Schedule(const System &system, std::function<void()> update) {
+    Task task;
+    task.system = &system;
+    task.update = std::move(update);
+    tasks.push_back(std::move(task));
+}
+
+void SystemScheduler::SubmitTask(int taskIndex) {
+    jobSystem.Submit(taskJobs, [this, taskIndex]() {
+        tasks[taskIndex].update();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        CompleteTask(taskIndex);
+    });
+}
+
+void SystemScheduler::PushReadyTask(int taskIndex) {
+    if (tasks[taskIndex].system->IsExclusive()) {
+        readyExclusiveTasks.push_back(taskIndex);
+    } else {
+        SubmitTask(taskIndex);
+    }
+}
+
+void SystemScheduler::CompleteTask(int taskIndex) {
+    numCompletedTasks++;
+    for (auto dependent: tasks[taskIndex].dependents) {
+        if (--tasks[dependent].pendingDependencies == 0) {
+            PushReadyTask(dependent);
+        }
+    }
+    taskCompleted.notify_one();
+}
+
+/// @brief Runs all scheduled updates and waits for them to finish
+/// @details
+/// 1. Builds the DAG: a task depends on every earlier task it conflicts with
+/// 2. Submits the tasks without dependencies as jobs
+/// 3. Each finished task releases its dependents, the calling thread runs the exclusive ones and helps
+///    running jobs while it waits
+/// 4. Returns once every task finished, the scheduled tasks are cleared for the next frame
+void SystemScheduler::Run() {
+    if (jobSystem.GetNumWorkers() == 0) {
+        for (auto &task: tasks) {
+            task.update();
+        }
+        tasks.clear();
+        return;
+    }
+
+    for (std::size_t j = 0; j < tasks.size(); j++) {
+        for (std::size_t i = 0; i < j; i++) {
+            if (tasks[i].system->ConflictsWith(*tasks[j].system)) {
+                tasks[i].dependents.push_back(static_cast<int>(j));
+                tasks[j].pendingDependencies++;
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    numCompletedTasks = 0;
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        if (tasks[i].pendingDependencies == 0) {
+            PushReadyTask(static_cast<int>(i));
+        }
+    }
+
+    while (numCompletedTasks < tasks.size()) {
+        if (!readyExclusiveTasks.empty()) {
+            const int taskIndex = readyExclusiveTasks.front();
+            readyExclusiveTasks.pop_front();
+
+            lock.unlock();
+            tasks[taskIndex].update();
+            lock.lock();
+            CompleteTask(taskIndex);
+            continue;
+        }
+
+        const std::size_t numCompletedTasksBefore = numCompletedTasks;
+        lock.unlock();
+        const bool hasRunJob = jobSystem.TryRunJob();
+        lock.lock();
+        if (!hasRunJob) {
+            taskCompleted.wait(lock, [this, numCompletedTasksBefore]() {
+                return numCompletedTasks != numCompletedTasksBefore || !readyExclusiveTasks.empty();
+            });
+        }
+    }
+    lock.unlock();
+
+    // The last jobs may still be returning after completing their tasks
+    jobSystem.Wait(taskJobs);
+    tasks.clear();
+}
@@ -0,0 +1,73 @@
+#ifndef SYSTEMSCHEDULER_H
+#define SYSTEMSCHEDULER_H
+
+#include "../JobSystem/JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class System;
+
+/// @brief Runs the system updates of a frame, in parallel when their component accesses do not conflict
+/// Tasks are scheduled in the order they would run serially. Each task depends on every earlier task it
+/// conflicts with (see System::ConflictsWith), which builds a DAG that keeps the results of the serial order.
+/// Ready tasks run as jobs of the JobSystem. Systems that do not declare their component access are exclusive:
+/// they conflict with every other task and always run on the thread that calls Run.
+class SystemScheduler {
+private:
+    struct Task {
+        const System *system;
+        std::function<void()> update;
+
+        /// @brief Tasks that can only start after this one finishes
+        std::vector<int> dependents;
+
+        /// @brief Number of earlier conflicting tasks that did not finish yet
+        int pendingDependencies = 0;
+    };
+
+    JobSystem &jobSystem;
+    std::vector<Task> tasks;
+
+    /// @brief Jobs of the tasks submitted to the job system
+    JobGroup taskJobs;
+
+    /// @brief Exclusive tasks whose dependencies finished, they only run on the thread that calls Run
+    std::deque<int> readyExclusiveTasks;
+
+    std::size_t numCompletedTasks = 0;
+
+    std::mutex mutex;
+    std::condition_variable taskCompleted;
+
+    /// @brief Submits a job that runs a task and completes it
+    void SubmitTask(int taskIndex);
+
+    /// @brief Queues a task whose dependencies finished (the mutex must be held)
+    void PushReadyTask(int taskIndex);
+
+    /// @brief Releases the dependents of a finished task (the mutex must be held)
+    void CompleteTask(int taskIndex);
+
+public:
+    /// @brief Creates the scheduler
+    /// @param jobSystem Job system that runs the tasks, without workers every task runs serially on the calling thread
+    explicit SystemScheduler(JobSystem &jobSystem) : jobSystem(jobSystem) {}
+
+    SystemScheduler(const SystemScheduler &) = delete;
+
+    SystemScheduler &operator=(const SystemScheduler &) = delete;
+
+    /// @brief Adds a system update to the next Run
+    /// @param system System that declares the component access of the update
+    /// @param update Function that updates the system
+    void Schedule(const System &system, std::function<void()> update);
+
+    /// @brief Runs all scheduled updates and waits for them to finish
+    void Run();
+};
+
+#endif /** SYSTEMSCHEDULER_H */
@@ -2,10 +2,12 @@
 #define EVENTBUS_H
 
 #include "../Logger/Logger.h"
+#include "../FrameArena/FrameArena.h"
 #include "Event.h"
 #include <map>
 #include <typeindex>
 #include <memory>
+#include <new>
 #include <list>
 #include <functional>
 
@@ -47,25 +49,40 @@ public:
     virtual ~EventCallback() override = default;
 };
 
-typedef std::list<std::unique_ptr<IEventCallback>> HandlerList;
+typedef std::list<IEventCallback *, FrameAllocator<IEventCallback *>> HandlerList;
 
+/// @brief Subscriptions are renewed every frame (Reset + SubscribeToEvent), so the callbacks, the handler lists
+/// and the map nodes all live in the frame arena instead of being allocated on the heap each frame
 class EventBus
 {
 private:
-    std::map<std::type_index, std::unique_ptr<HandlerList>> subscribers;
+    FrameArena &frameArena;
+    std::map<std::type_index, HandlerList, std::less<std::type_index>,
+             FrameAllocator<std::pair<const std::type_index, HandlerList>>> subscribers;
 
 public:
-    EventBus()
+    /// @param frameArena Arena of the frame, Reset must be called before the arena is reset
+    explicit EventBus(FrameArena &frameArena)
+        : frameArena(frameArena),
+          subscribers(FrameAllocator<std::pair<const std::type_index, HandlerList>>(frameArena))
     {
         Logger::Log("EventBus constructor Called!");
     }
 
     ~EventBus()
     {
+        Reset();
         Logger::Log("EventBus destructor Called!");
     }
 
     void Reset() {
+        for (auto &subscriber: subscribers)
+        {
+            for (auto callback: subscriber.second)
+            {
+                callback->~IEventCallback();
+            }
+        }
         subscribers.clear();
     }
 
@@ -73,25 +90,26 @@ public:
     void SubscribeToEvent(TOwner *ownerInstance, void (TOwner::*callbackFunction)(TEvent &))
     {
 
-        if (!subscribers[typeid(TEvent)].get())
+        auto handlers = subscribers.find(typeid(TEvent));
+        if (handlers == subscribers.end())
         {
-            subscribers[typeid(TEvent)] = std::make_unique<HandlerList>();
+            handlers = subscribers.emplace(typeid(TEvent), HandlerList(FrameAllocator<IEventCallback *>(frameArena))).first;
         }
 
-        auto subscriber = std::make_unique<EventCallback<TOwner, TEvent>>(ownerInstance, callbackFunction);
-        subscribers[typeid(TEvent)]->push_back(std::move(subscriber));
+        void *memory = frameArena.Allocate(sizeof(EventCallback<TOwner, TEvent>), alignof(EventCallback<TOwner, TEvent>));
+        handlers->second.push_back(new(memory) EventCallback<TOwner, TEvent>(ownerInstance, callbackFunction));
     }
 
     template <typename TEvent, typename... TArgs>
     void EmitEvent(TArgs... args)
     {
-        auto handlers = subscribers[typeid(TEvent)].get();
+        auto handlers = subscribers.find(typeid(TEvent));
 
-        if (handlers)
+        if (handlers != subscribers.end())
         {
-            for (auto it = handlers->begin(); it != handlers->end(); it++)
+            for (auto it = handlers->second.begin(); it != handlers->second.end(); it++)
             {
-                auto handler = it->get();
+                auto handler = *it;
                 TEvent event(std::forward<TArgs>(args)...);
                 handler->Execute(event);
             }
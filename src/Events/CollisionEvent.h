@@ -4,6 +4,7 @@
 #include "../ECS/ECS.h"
 #include "../EventBus/Event.h"
 
+/// @brief Pair of colliding entities, base of the contact events emitted by the CollisionSystem
 class CollisionEvent: public Event
 {
 public:
@@ -12,4 +13,26 @@ public:
     CollisionEvent(Entity a, Entity b) : a(a), b(b) {}
 };
 
-#endif /// COLLISIONEVEMT_H
\ No newline at end of file
+/// @brief Emitted in the first frame two colliders overlap
+class CollisionEnterEvent: public CollisionEvent
+{
+public:
+    CollisionEnterEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
+/// @brief Emitted every following frame the colliders still overlap, only when the layer of one of them reports
+/// it (see CollisionSystem::SetLayerReportsStay)
+class CollisionStayEvent: public CollisionEvent
+{
+public:
+    CollisionStayEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
+/// @brief Emitted in the first frame the colliders stopped overlapping, not when one of the entities was killed
+class CollisionExitEvent: public CollisionEvent
+{
+public:
+    CollisionExitEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
+#endif /// COLLISIONEVEMT_H
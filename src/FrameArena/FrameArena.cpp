@@ -0,0 +1,47 @@
+#include "FrameArena.h"
+
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t capacity) {
+    AddBlock(capacity > 0 ? capacity : 1);
+}
+
+void FrameArena::AddBlock(std::size_t size) {
+    blocks.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    offset = 0;
+}
+
+void *FrameArena::Allocate(std::size_t size, std::size_t alignment) {
+    const Block &block = blocks.back();
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(block.memory.get());
+    const std::uintptr_t address = (begin + offset + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+
+    if (address + size > begin + block.size) {
+        // Grow geometrically, Reset merges the blocks so this only happens while the frames get bigger
+        const std::size_t blockSize = block.size * 2 > size + alignment ? block.size * 2 : size + alignment;
+        AddBlock(blockSize);
+        return Allocate(size, alignment);
+    }
+
+    usedBytes += address + size - (begin + offset);
+    offset = address + size - begin;
+    return reinterpret_cast<void *>(address);
+}
+
+void FrameArena::Reset() {
+    if (blocks.size() > 1) {
+        const std::size_t capacity = GetCapacity();
+        blocks.clear();
+        AddBlock(capacity);
+    }
+    offset = 0;
+    usedBytes = 0;
+}
+
+std::size_t FrameArena::GetCapacity() const {
+    std::size_t capacity = 0;
+    for (const auto &block: blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
@@ -0,0 +1,87 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/// @brief Linear (bump) allocator for memory that only lives during one frame
+/// Allocating moves an offset forward inside a block and freeing does nothing, Reset() makes the whole block
+/// available again. When a frame needs more than the block holds, extra blocks are allocated and the next
+/// Reset() replaces them with one block as large as all of them, so after the first frames the arena stops
+/// touching the heap.
+/// It is not thread-safe: allocate from the thread that runs Game::Update and Game::Render.
+class FrameArena {
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        std::size_t size;
+    };
+
+    /// @brief Blocks used by the current frame, allocations come from the last one
+    std::vector<Block> blocks;
+
+    /// @brief Offset of the first free byte of the last block
+    std::size_t offset = 0;
+
+    /// @brief Bytes allocated since the last Reset, including alignment padding
+    std::size_t usedBytes = 0;
+
+    void AddBlock(std::size_t size);
+
+public:
+    static const std::size_t DEFAULT_CAPACITY = 1024 * 1024;
+
+    /// @brief Creates the arena
+    /// @param capacity Size of the first block in bytes
+    explicit FrameArena(std::size_t capacity = DEFAULT_CAPACITY);
+
+    FrameArena(const FrameArena &) = delete;
+
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /// @brief Allocates memory that stays valid until the next Reset
+    /// @param size Number of bytes
+    /// @param alignment Alignment of the memory, a power of two
+    void *Allocate(std::size_t size, std::size_t alignment);
+
+    /// @brief Releases every allocation at once, objects that live in the arena must be destroyed before
+    void Reset();
+
+    std::size_t GetUsedBytes() const { return usedBytes; }
+
+    std::size_t GetCapacity() const;
+};
+
+/// @brief STL allocator that takes its memory from a FrameArena, deallocate does nothing
+/// e.g. std::vector<int, FrameAllocator<int> > values{FrameAllocator<int>(frameArena)};
+template<typename T>
+class FrameAllocator {
+private:
+    FrameArena *arena;
+
+    template<typename U>
+    friend class FrameAllocator;
+
+public:
+    typedef T value_type;
+
+    explicit FrameAllocator(FrameArena &arena) noexcept : arena(&arena) {}
+
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U> &other) noexcept : arena(other.arena) {}
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, std::size_t) noexcept {}
+
+    template<typename U>
+    bool operator==(const FrameAllocator<U> &other) const { return arena == other.arena; }
+
+    template<typename U>
+    bool operator!=(const FrameAllocator<U> &other) const { return arena != other.arena; }
+};
+
+#endif /** FRAMEARENA_H */
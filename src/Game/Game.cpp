@@ -34,12 +34,14 @@ int Game::mapHeight;
 
 /// @brief Constructor for the Game class
 /// @details Initializes the game state to not running and logs creation
-Game::Game() {
+/// @param storageMode Backend used by the registry to store component data
+Game::Game(StorageMode storageMode) {
     isRunning = false;
     isDebug = false;
-    registry = std::make_unique<Registry>();
+    frameArena = std::make_unique<FrameArena>();
+    registry = std::make_unique<Registry>(storageMode);
     assetStore = std::make_unique<AssetStore>();
-    eventBus = std::make_unique<EventBus>();
+    eventBus = std::make_unique<EventBus>(*frameArena);
     Logger::Log("Game constructor called!");
 }
 
@@ -177,7 +179,7 @@ void Game::Setup() {
     registry->AddSystem<ScriptSystem>();
 
     // Create the bindings between C++ and Lua
-    registry->GetSystem<ScriptSystem>().CreateLuaBindings(lua);
+    registry->GetSystem<ScriptSystem>().CreateLuaBindings(lua, registry);
 
     LevelLoader loader;
     lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
@@ -189,6 +191,12 @@ void Game::Setup() {
 void Game::Update() {
     // TODO: Update game objects
 
+    // Reset all event handlers for the current frame, they live in the frame arena so they go first
+    eventBus->Reset();
+
+    // Release the transient memory of the previous frame
+    frameArena->Reset();
+
     // If we are to fast, waste some time until we reach the MILLISECS_PER_FRAME
     int timeToWait = MILLISECS_PER_FRAME - (SDL_GetTicks() - millisecsPreviousFrame);
 
@@ -202,9 +210,6 @@ void Game::Update() {
     // Store the current frame time
     millisecsPreviousFrame = SDL_GetTicks();
 
-    // Reset all event handlers for the current frame
-    eventBus->Reset();
-
     // Perform the subscription of the events for all systems
     registry->GetSystem<MovementSystem>().SubscribeToEvents(eventBus);
     registry->GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
@@ -215,13 +220,23 @@ void Game::Update() {
     registry->Update();
 
     // Invoke al the systems that need to update
-    registry->GetSystem<MovementSystem>().Update(deltaTime);
-    registry->GetSystem<AnimationSystem>().Update();
-    registry->GetSystem<CollisionSystem>().Update(eventBus);
-    registry->GetSystem<ProjectileEmitSystem>().Update(registry);
-    registry->GetSystem<CameraMovementSystem>().Update(camera);
-    registry->GetSystem<ProjectileLifecycleSystem>().Update();
-    registry->GetSystem<ScriptSystem>().Update(deltaTime, SDL_GetTicks());
+    // Systems that declare their component access run in parallel when they do not conflict, e.g. the
+    // animation and projectile lifecycle systems run alongside the movement system, and the camera
+    // movement system waits for the movement system because it reads the transforms it writes
+    registry->ScheduleSystem<MovementSystem>([this, deltaTime](MovementSystem &system) {
+        system.Update(registry, deltaTime);
+    });
+    registry->ScheduleSystem<AnimationSystem>([this](AnimationSystem &system) { system.Update(registry); });
+    registry->ScheduleSystem<ProjectileLifecycleSystem>([](ProjectileLifecycleSystem &system) { system.Update(); });
+    registry->ScheduleSystem<CameraMovementSystem>([this](CameraMovementSystem &system) { system.Update(camera); });
+    registry->ScheduleSystem<CollisionSystem>([this](CollisionSystem &system) {
+        system.Update(registry, eventBus, *frameArena);
+    });
+    registry->ScheduleSystem<ProjectileEmitSystem>([this](ProjectileEmitSystem &system) { system.Update(registry); });
+    registry->ScheduleSystem<ScriptSystem>([this, deltaTime](ScriptSystem &system) {
+        system.Update(deltaTime, SDL_GetTicks());
+    });
+    registry->RunScheduledSystems();
 }
 
 /// @brief Renders the game state
@@ -233,7 +248,7 @@ void Game::Render() {
     SDL_RenderClear(renderer);
 
     // Invoke all the systems that need to render
-    registry->GetSystem<RenderSystem>().Update(renderer, assetStore, camera);
+    registry->GetSystem<RenderSystem>().Update(registry, renderer, assetStore, camera, *frameArena);
     registry->GetSystem<RenderTextSystem>().Update(renderer, assetStore, camera);
     registry->GetSystem<RenderHealthBarSystem>().Update(renderer, assetStore, camera);
     if (isDebug) {
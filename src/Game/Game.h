@@ -8,6 +8,7 @@
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
 #include "../EventBus/EventBus.h"
+#include "../FrameArena/FrameArena.h"
 #include <SDL2/SDL.h>
 #include <memory>
 #include <sol/sol.hpp>
@@ -29,13 +30,17 @@ private:
 
     sol::state lua;
 
+    /// @brief Memory of the transient per-frame containers, reset at the top of Update
+    std::unique_ptr<FrameArena> frameArena;
+
     std::unique_ptr<Registry> registry;
     std::unique_ptr<AssetStore> assetStore;
     std::unique_ptr<EventBus> eventBus;
 
 public:
     /// @brief Constructor for the Game class
-    Game();
+    /// @param storageMode Backend used by the registry to store component data
+    Game(StorageMode storageMode = StorageMode::Pools);
 
     /// @brief Destructor for the Game class
     /// @details Ensures proper cleanup of resources
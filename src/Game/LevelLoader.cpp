@@ -11,6 +11,8 @@
 #include "../Components/HealthComponent.h"
 #include "../Components/ScriptComponent.h"
 #include "../Components/TextLabelComponent.h"
+#include "../Components/ProjectileComponent.h"
+#include "../Systems/CollisionSystem.h"
 #include <fstream>
 #include <string>
 #include <sol/sol.hpp>
@@ -23,6 +25,160 @@ LevelLoader::~LevelLoader() {
     Logger::Log("LevelLoader destructor called!");
 }
 
+/// @brief Adds the components declared in the "components" table of a level entity (or prefab)
+/// @param target Entity or Prefab, both take the components through AddComponent<T>(args...)
+/// @param entity Lua table with the entity declaration
+/// @param registry Registry of the level, its CollisionSystem resolves the names of the collision layers
+template<typename TTarget>
+static void AddComponentsFromTable(TTarget &target, sol::table entity, const std::unique_ptr<Registry> &registry) {
+    sol::optional<sol::table> hasComponents = entity["components"];
+    if (hasComponents != sol::nullopt) {
+        // Transform
+        sol::optional<sol::table> transform = entity["components"]["transform"];
+        if (transform != sol::nullopt) {
+            target.template AddComponent<TransformComponent>(
+                glm::vec2(
+                    entity["components"]["transform"]["position"]["x"],
+                    entity["components"]["transform"]["position"]["y"]
+                ),
+                glm::vec2(
+                    entity["components"]["transform"]["scale"]["x"].get_or(1.0),
+                    entity["components"]["transform"]["scale"]["y"].get_or(1.0)
+                ),
+                entity["components"]["transform"]["rotation"].get_or(0.0)
+            );
+        }
+
+        // RigidBody
+        sol::optional<sol::table> rigidbody = entity["components"]["rigidbody"];
+        if (rigidbody != sol::nullopt) {
+            target.template AddComponent<RigidbodyComponent>(
+                glm::vec2(
+                    entity["components"]["rigidbody"]["velocity"]["x"].get_or(0.0),
+                    entity["components"]["rigidbody"]["velocity"]["y"].get_or(0.0)
+                )
+            );
+        }
+
+        // Sprite
+        sol::optional<sol::table> sprite = entity["components"]["sprite"];
+        if (sprite != sol::nullopt) {
+            target.template AddComponent<SpriteComponent>(
+                entity["components"]["sprite"]["texture_asset_id"],
+                entity["components"]["sprite"]["width"],
+                entity["components"]["sprite"]["height"],
+                entity["components"]["sprite"]["z_index"].get_or(1),
+                entity["components"]["sprite"]["fixed"].get_or(false),
+                entity["components"]["sprite"]["src_rect_x"].get_or(0),
+                entity["components"]["sprite"]["src_rect_y"].get_or(0)
+            );
+        }
+
+        // Animation
+        sol::optional<sol::table> animation = entity["components"]["animation"];
+        if (animation != sol::nullopt) {
+            target.template AddComponent<AnimationComponent>(
+                entity["components"]["animation"]["num_frames"].get_or(1),
+                entity["components"]["animation"]["speed_rate"].get_or(1)
+            );
+        }
+
+        // BoxCollider
+        sol::optional<sol::table> collider = entity["components"]["boxcollider"];
+        if (collider != sol::nullopt) {
+            int layer = 0;
+            std::uint32_t mask = ALL_COLLISION_LAYERS;
+            if (registry->HasSystem<CollisionSystem>()) {
+                CollisionSystem &collisionSystem = registry->GetSystem<CollisionSystem>();
+
+                sol::optional<std::string> layerName = entity["components"]["boxcollider"]["layer"];
+                if (layerName != sol::nullopt) {
+                    layer = collisionSystem.GetLayer(layerName.value());
+                }
+
+                // Optional list of layer names, narrows the layers the collider collides with
+                sol::optional<sol::table> maskLayers = entity["components"]["boxcollider"]["mask"];
+                if (maskLayers != sol::nullopt) {
+                    mask = 0;
+                    for (const auto &maskLayer: maskLayers.value()) {
+                        mask |= 1u << collisionSystem.GetLayer(maskLayer.second.as<std::string>());
+                    }
+                }
+            }
+
+            target.template AddComponent<BoxColliderComponent>(
+                entity["components"]["boxcollider"]["width"],
+                entity["components"]["boxcollider"]["height"],
+                glm::vec2(
+                    entity["components"]["boxcollider"]["offset"]["x"].get_or(0),
+                    entity["components"]["boxcollider"]["offset"]["y"].get_or(0)
+                ),
+                layer,
+                mask
+            );
+        }
+
+        // Health
+        sol::optional<sol::table> health = entity["components"]["health"];
+        if (health != sol::nullopt) {
+            target.template AddComponent<HealthComponent>(
+                static_cast<int>(entity["components"]["health"]["health_percentage"].get_or(100))
+            );
+        }
+
+        // ProjectileEmitter
+        sol::optional<sol::table> projectileEmitter = entity["components"]["projectile_emitter"];
+        if (projectileEmitter != sol::nullopt) {
+            target.template AddComponent<ProjectileEmitterComponent>(
+                glm::vec2(
+                    entity["components"]["projectile_emitter"]["projectile_velocity"]["x"],
+                    entity["components"]["projectile_emitter"]["projectile_velocity"]["y"]
+                ),
+                static_cast<int>(entity["components"]["projectile_emitter"]["repeat_frequency"].get_or(1)) * 1000,
+                static_cast<int>(entity["components"]["projectile_emitter"]["projectile_duration"].get_or(10)) *
+                1000,
+                static_cast<int>(entity["components"]["projectile_emitter"]["hit_percentage_damage"].get_or(10)),
+                entity["components"]["projectile_emitter"]["friendly"].get_or(false)
+            );
+        }
+
+        // CameraFollow
+        sol::optional<sol::table> cameraFollow = entity["components"]["camera_follow"];
+        if (cameraFollow != sol::nullopt) {
+            target.template AddComponent<CameraFollowComponent>();
+        }
+
+        // KeyboardControlled
+        sol::optional<sol::table> keyboardControlled = entity["components"]["keyboard_controller"];
+        if (keyboardControlled != sol::nullopt) {
+            target.template AddComponent<KeyboardControlledComponent>(
+                glm::vec2(
+                    entity["components"]["keyboard_controller"]["up_velocity"]["x"],
+                    entity["components"]["keyboard_controller"]["up_velocity"]["y"]
+                ),
+                glm::vec2(
+                    entity["components"]["keyboard_controller"]["right_velocity"]["x"],
+                    entity["components"]["keyboard_controller"]["right_velocity"]["y"]
+                ),
+                glm::vec2(
+                    entity["components"]["keyboard_controller"]["down_velocity"]["x"],
+                    entity["components"]["keyboard_controller"]["down_velocity"]["y"]
+                ),
+                glm::vec2(
+                    entity["components"]["keyboard_controller"]["left_velocity"]["x"],
+                    entity["components"]["keyboard_controller"]["left_velocity"]["y"]
+                )
+            );
+        }
+
+        sol::optional<sol::table> script = entity["components"]["on_update_script"];
+        if (script != sol::nullopt) {
+            sol::function func = entity["components"]["on_update_script"][0];
+            target.template AddComponent<ScriptComponent>(func);
+        }
+    }
+}
+
 void LevelLoader::LoadLevel(sol::state &lua, const std::unique_ptr<Registry> &registry,
                             const std::unique_ptr<AssetStore> &assetStore, SDL_Renderer *renderer, int levelNumber) {
     // This checks the syntax of our script, but it does not execute the script
@@ -40,6 +196,25 @@ void LevelLoader::LoadLevel(sol::state &lua, const std::unique_ptr<Registry> &re
     // Read the big table for the current level
     sol::table level = lua["Level"];
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Reserve room for the entity and component counts the level expects, so the pools do not grow (copying
+    // every component) while loading or when the first waves of projectiles are fired
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> hasExpectedCounts = level["expected_counts"];
+    if (hasExpectedCounts != sol::nullopt) {
+        sol::table expectedCounts = hasExpectedCounts.value();
+        registry->ReserveEntities(expectedCounts["entities"].get_or(0));
+        registry->Reserve<TransformComponent>(expectedCounts["transform"].get_or(0));
+        registry->Reserve<RigidbodyComponent>(expectedCounts["rigidbody"].get_or(0));
+        registry->Reserve<SpriteComponent>(expectedCounts["sprite"].get_or(0));
+        registry->Reserve<AnimationComponent>(expectedCounts["animation"].get_or(0));
+        registry->Reserve<BoxColliderComponent>(expectedCounts["boxcollider"].get_or(0));
+        registry->Reserve<HealthComponent>(expectedCounts["health"].get_or(0));
+        registry->Reserve<ProjectileEmitterComponent>(expectedCounts["projectile_emitter"].get_or(0));
+        registry->Reserve<ProjectileComponent>(expectedCounts["projectile"].get_or(0));
+        registry->Reserve<ScriptComponent>(expectedCounts["on_update_script"].get_or(0));
+    }
+
     ////////////////////////////////////////////////////////////////////////////
     // Read the level assets
     ////////////////////////////////////////////////////////////////////////////
@@ -77,6 +252,13 @@ void LevelLoader::LoadLevel(sol::state &lua, const std::unique_ptr<Registry> &re
     double mapScale = map["scale"];
     std::fstream mapFile;
     mapFile.open(mapFilePath);
+
+    // The tiles are created and filled in two batches, see Registry::CreateEntities and AddComponents
+    const int numTiles = mapNumRows * mapNumCols;
+    std::vector<TransformComponent> tileTransforms;
+    std::vector<SpriteComponent> tileSprites;
+    tileTransforms.reserve(numTiles);
+    tileSprites.reserve(numTiles);
     for (int y = 0; y < mapNumRows; y++) {
         for (int x = 0; x < mapNumCols; x++) {
             char ch;
@@ -86,16 +268,66 @@ void LevelLoader::LoadLevel(sol::state &lua, const std::unique_ptr<Registry> &re
             int srcRectX = std::atoi(&ch) * tileSize;
             mapFile.ignore();
 
-            Entity tile = registry->CreateEntity();
-            tile.AddComponent<TransformComponent>(glm::vec2(x * (mapScale * tileSize), y * (mapScale * tileSize)),
-                                                  glm::vec2(mapScale, mapScale), 0.0);
-            tile.AddComponent<SpriteComponent>(mapTextureAssetId, tileSize, tileSize, 0, false, srcRectX, srcRectY);
+            tileTransforms.emplace_back(glm::vec2(x * (mapScale * tileSize), y * (mapScale * tileSize)),
+                                        glm::vec2(mapScale, mapScale), 0.0);
+            tileSprites.emplace_back(mapTextureAssetId, tileSize, tileSize, 0, false, srcRectX, srcRectY);
         }
     }
     mapFile.close();
+    const std::vector<Entity> tiles = registry->CreateEntities(numTiles);
+    registry->AddComponents(tiles, std::move(tileTransforms), std::move(tileSprites));
     Game::mapWidth = mapNumCols * tileSize * mapScale;
     Game::mapHeight = mapNumRows * tileSize * mapScale;
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Read the collision settings of the level
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> hasCollision = level["collision"];
+    if (hasCollision != sol::nullopt && registry->HasSystem<CollisionSystem>()) {
+        sol::table collision = hasCollision.value();
+        CollisionSystem &collisionSystem = registry->GetSystem<CollisionSystem>();
+        collisionSystem.SetCellSize(collision["cell_size"].get_or(SpatialHash::DEFAULT_CELL_SIZE));
+
+        // Layer interaction matrix, once a level lists its layers only the listed pairs of layers collide
+        sol::optional<sol::table> hasLayers = collision["layers"];
+        if (hasLayers != sol::nullopt) {
+            collisionSystem.ClearLayerCollisions();
+            for (const auto &layerEntry: hasLayers.value()) {
+                const int layer = collisionSystem.GetLayer(layerEntry.first.as<std::string>());
+                sol::table otherLayers = layerEntry.second;
+                for (const auto &otherLayer: otherLayers) {
+                    collisionSystem.SetLayersCollide(layer, collisionSystem.GetLayer(otherLayer.second.as<std::string>()));
+                }
+            }
+        }
+
+        // Layers whose contacts emit a stay event every frame, the others only emit enter and exit
+        sol::optional<sol::table> hasStayLayers = collision["stay_layers"];
+        if (hasStayLayers != sol::nullopt) {
+            for (const auto &stayLayer: hasStayLayers.value()) {
+                collisionSystem.SetLayerReportsStay(collisionSystem.GetLayer(stayLayer.second.as<std::string>()));
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Read the level prefabs, scripts spawn copies of them with spawn_many(name, count)
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> hasPrefabs = level["prefabs"];
+    if (hasPrefabs != sol::nullopt) {
+        for (const auto &prefabEntry: hasPrefabs.value()) {
+            sol::table prefabTable = prefabEntry.second;
+            Prefab &prefab = registry->CreatePrefab(prefabEntry.first.as<std::string>());
+
+            sol::optional<std::string> group = prefabTable["group"];
+            if (group != sol::nullopt) {
+                prefab.Group(registry->GetGroupId(group.value()));
+            }
+
+            AddComponentsFromTable(prefab, prefabTable, registry);
+        }
+    }
+
     ////////////////////////////////////////////////////////////////////////////
     // Read the level entities and their components
     ////////////////////////////////////////////////////////////////////////////
@@ -111,143 +343,20 @@ void LevelLoader::LoadLevel(sol::state &lua, const std::unique_ptr<Registry> &re
 
         Entity newEntity = registry->CreateEntity();
 
-        // Tag
+        // Tag (names are interned once here, the systems work with the ids)
         sol::optional<std::string> tag = entity["tag"];
         if (tag != sol::nullopt) {
-            newEntity.Tag(entity["tag"]);
+            newEntity.Tag(registry->GetTagId(tag.value()));
         }
 
         // Group
         sol::optional<std::string> group = entity["group"];
         if (group != sol::nullopt) {
-            newEntity.Group(entity["group"]);
+            newEntity.Group(registry->GetGroupId(group.value()));
         }
 
         // Components
-        sol::optional<sol::table> hasComponents = entity["components"];
-        if (hasComponents != sol::nullopt) {
-            // Transform
-            sol::optional<sol::table> transform = entity["components"]["transform"];
-            if (transform != sol::nullopt) {
-                newEntity.AddComponent<TransformComponent>(
-                    glm::vec2(
-                        entity["components"]["transform"]["position"]["x"],
-                        entity["components"]["transform"]["position"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["transform"]["scale"]["x"].get_or(1.0),
-                        entity["components"]["transform"]["scale"]["y"].get_or(1.0)
-                    ),
-                    entity["components"]["transform"]["rotation"].get_or(0.0)
-                );
-            }
-
-            // RigidBody
-            sol::optional<sol::table> rigidbody = entity["components"]["rigidbody"];
-            if (rigidbody != sol::nullopt) {
-                newEntity.AddComponent<RigidbodyComponent>(
-                    glm::vec2(
-                        entity["components"]["rigidbody"]["velocity"]["x"].get_or(0.0),
-                        entity["components"]["rigidbody"]["velocity"]["y"].get_or(0.0)
-                    )
-                );
-            }
-
-            // Sprite
-            sol::optional<sol::table> sprite = entity["components"]["sprite"];
-            if (sprite != sol::nullopt) {
-                newEntity.AddComponent<SpriteComponent>(
-                    entity["components"]["sprite"]["texture_asset_id"],
-                    entity["components"]["sprite"]["width"],
-                    entity["components"]["sprite"]["height"],
-                    entity["components"]["sprite"]["z_index"].get_or(1),
-                    entity["components"]["sprite"]["fixed"].get_or(false),
-                    entity["components"]["sprite"]["src_rect_x"].get_or(0),
-                    entity["components"]["sprite"]["src_rect_y"].get_or(0)
-                );
-            }
-
-            // Animation
-            sol::optional<sol::table> animation = entity["components"]["animation"];
-            if (animation != sol::nullopt) {
-                newEntity.AddComponent<AnimationComponent>(
-                    entity["components"]["animation"]["num_frames"].get_or(1),
-                    entity["components"]["animation"]["speed_rate"].get_or(1)
-                );
-            }
-
-            // BoxCollider
-            sol::optional<sol::table> collider = entity["components"]["boxcollider"];
-            if (collider != sol::nullopt) {
-                newEntity.AddComponent<BoxColliderComponent>(
-                    entity["components"]["boxcollider"]["width"],
-                    entity["components"]["boxcollider"]["height"],
-                    glm::vec2(
-                        entity["components"]["boxcollider"]["offset"]["x"].get_or(0),
-                        entity["components"]["boxcollider"]["offset"]["y"].get_or(0)
-                    )
-                );
-            }
-
-            // Health
-            sol::optional<sol::table> health = entity["components"]["health"];
-            if (health != sol::nullopt) {
-                newEntity.AddComponent<HealthComponent>(
-                    static_cast<int>(entity["components"]["health"]["health_percentage"].get_or(100))
-                );
-            }
-
-            // ProjectileEmitter
-            sol::optional<sol::table> projectileEmitter = entity["components"]["projectile_emitter"];
-            if (projectileEmitter != sol::nullopt) {
-                newEntity.AddComponent<ProjectileEmitterComponent>(
-                    glm::vec2(
-                        entity["components"]["projectile_emitter"]["projectile_velocity"]["x"],
-                        entity["components"]["projectile_emitter"]["projectile_velocity"]["y"]
-                    ),
-                    static_cast<int>(entity["components"]["projectile_emitter"]["repeat_frequency"].get_or(1)) * 1000,
-                    static_cast<int>(entity["components"]["projectile_emitter"]["projectile_duration"].get_or(10)) *
-                    1000,
-                    static_cast<int>(entity["components"]["projectile_emitter"]["hit_percentage_damage"].get_or(10)),
-                    entity["components"]["projectile_emitter"]["friendly"].get_or(false)
-                );
-            }
-
-            // CameraFollow
-            sol::optional<sol::table> cameraFollow = entity["components"]["camera_follow"];
-            if (cameraFollow != sol::nullopt) {
-                newEntity.AddComponent<CameraFollowComponent>();
-            }
-
-            // KeyboardControlled
-            sol::optional<sol::table> keyboardControlled = entity["components"]["keyboard_controller"];
-            if (keyboardControlled != sol::nullopt) {
-                newEntity.AddComponent<KeyboardControlledComponent>(
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["up_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["up_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["right_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["right_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["down_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["down_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["left_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["left_velocity"]["y"]
-                    )
-                );
-            }
-
-            sol::optional<sol::table> script = entity["components"]["on_update_script"];
-            if (script != sol::nullopt) {
-                sol::function func = entity["components"]["on_update_script"][0];
-                newEntity.AddComponent<ScriptComponent>(func);
-            }
-        }
+        AddComponentsFromTable(newEntity, entity, registry);
         i++;
     }
 }
@@ -0,0 +1,131 @@
+#include "JobSystem.h"
+
+/// @brief Job system that owns the calling thread (nullptr for threads that are not workers)
+static thread_local const JobSystem *currentJobSystem = nullptr;
+
+/// @brief Worker index of the calling thread inside currentJobSystem
+static thread_local int currentWorkerIndex = -1;
+
+/// @brief Number of jobs being run by the calling thread (jobs can run other jobs while waiting)
+static thread_local int numRunningJobs = 0;
+
+JobSystem::JobSystem(unsigned int numWorkers) {
+    for (unsigned int i = 0; i <= numWorkers; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned int i = 0; i < numWorkers; i++) {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<int>(i));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        isShuttingDown = true;
+    }
+    jobAvailable.notify_all();
+    for (auto &worker: workers) {
+        worker.join();
+    }
+}
+
+unsigned int JobSystem::DefaultNumWorkers() {
+    const unsigned int numThreads = std::thread::hardware_concurrency();
+    return numThreads > 1 ? numThreads - 1 : 0;
+}
+
+int JobSystem::GetThreadIndex() const {
+    return currentJobSystem == this ? currentWorkerIndex : static_cast<int>(workers.size());
+}
+
+bool JobSystem::IsRunningJob() {
+    return numRunningJobs > 0;
+}
+
+void JobSystem::Submit(JobGroup &group, std::function<void()> job) {
+    group.numPendingJobs.fetch_add(1, std::memory_order_relaxed);
+
+    WorkQueue &queue = *queues[GetThreadIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(Job{std::move(job), &group});
+    }
+    numQueuedJobs.fetch_add(1, std::memory_order_release);
+
+    // Taking the sleep mutex makes sure a worker that is about to sleep sees the new job
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    jobAvailable.notify_one();
+}
+
+/// @brief Pops the most recent job of a queue
+bool JobSystem::PopJob(int queueIndex, Job &job) {
+    WorkQueue &queue = *queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+/// @brief Steals the oldest job of any other queue
+bool JobSystem::StealJob(int thiefIndex, Job &job) {
+    const int numQueues = static_cast<int>(queues.size());
+    for (int offset = 1; offset < numQueues; offset++) {
+        WorkQueue &queue = *queues[(thiefIndex + offset) % numQueues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::TryRunJob() {
+    if (numQueuedJobs.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    const int threadIndex = GetThreadIndex();
+    Job job;
+    if (!PopJob(threadIndex, job) && !StealJob(threadIndex, job)) {
+        return false;
+    }
+    numQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+    numRunningJobs++;
+    job.function();
+    numRunningJobs--;
+
+    job.group->numPendingJobs.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::Wait(JobGroup &group) {
+    while (!group.IsDone()) {
+        if (!TryRunJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WorkerLoop(int workerIndex) {
+    currentJobSystem = this;
+    currentWorkerIndex = workerIndex;
+
+    while (!isShuttingDown) {
+        if (TryRunJob()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        jobAvailable.wait(lock, [this]() {
+            return isShuttingDown || numQueuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
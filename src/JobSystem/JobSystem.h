@@ -0,0 +1,120 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Counter of the unfinished jobs submitted together, used to wait for all of them
+class JobGroup {
+private:
+    std::atomic<int> numPendingJobs{0};
+
+    friend class JobSystem;
+
+public:
+    bool IsDone() const { return numPendingJobs.load(std::memory_order_acquire) == 0; }
+};
+
+/// @brief Engine-wide pool of worker threads with work-stealing queues
+/// Every worker owns a queue: it pushes and pops its own jobs at the back (most recent first) and steals from
+/// the front of the other queues when its own is empty. Jobs submitted by other threads go to an extra shared
+/// queue. Threads that wait for a JobGroup run pending jobs instead of blocking, so jobs can submit and wait
+/// for other jobs.
+class JobSystem {
+private:
+    struct Job {
+        std::function<void()> function;
+        JobGroup *group;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    /// @brief One queue per worker, plus the queue of the other threads at index GetNumWorkers()
+    std::vector<std::unique_ptr<WorkQueue> > queues;
+
+    std::vector<std::thread> workers;
+    std::atomic<int> numQueuedJobs{0};
+    std::atomic<bool> isShuttingDown{false};
+    std::mutex sleepMutex;
+    std::condition_variable jobAvailable;
+
+    void WorkerLoop(int workerIndex);
+
+    bool PopJob(int queueIndex, Job &job);
+
+    bool StealJob(int thiefIndex, Job &job);
+
+public:
+    /// @brief Creates the job system and starts its worker threads
+    /// @param numWorkers Number of worker threads, with 0 every job runs on the thread that submits it
+    explicit JobSystem(unsigned int numWorkers = DefaultNumWorkers());
+
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    /// @brief Gets one worker per hardware thread, minus the main thread
+    static unsigned int DefaultNumWorkers();
+
+    std::size_t GetNumWorkers() const { return workers.size(); }
+
+    /// @brief Gets the index of the calling thread
+    /// @return Worker index, or GetNumWorkers() when called from a thread that is not a worker of this job system
+    int GetThreadIndex() const;
+
+    /// @brief Checks if the calling thread is running a job (of any job system)
+    static bool IsRunningJob();
+
+    /// @brief Queues a job
+    /// @param group Group that tracks the job, it must outlive the job
+    /// @param job Function to run
+    void Submit(JobGroup &group, std::function<void()> job);
+
+    /// @brief Runs one pending job on the calling thread, if there is any
+    /// @return true if a job was run
+    bool TryRunJob();
+
+    /// @brief Runs pending jobs until all the jobs of a group finished
+    void Wait(JobGroup &group);
+
+    /// @brief Splits the range [0, count) in chunks and processes them in parallel
+    /// @param count Number of items
+    /// @param chunkSize Number of items per job
+    /// @param function Called as function(begin, end) for each chunk, possibly from several threads at once
+    template<typename TFunction>
+    void ParallelFor(int count, int chunkSize, const TFunction &function);
+};
+
+template<typename TFunction>
+void JobSystem::ParallelFor(int count, int chunkSize, const TFunction &function) {
+    if (chunkSize <= 0) {
+        chunkSize = 1;
+    }
+
+    if (workers.empty() || count <= chunkSize) {
+        if (count > 0) {
+            function(0, count);
+        }
+        return;
+    }
+
+    JobGroup group;
+    for (int begin = 0; begin < count; begin += chunkSize) {
+        const int end = begin + chunkSize < count ? begin + chunkSize : count;
+        Submit(group, [&function, begin, end]() { function(begin, end); });
+    }
+    Wait(group);
+}
+
+#endif /** JOBSYSTEM_H */
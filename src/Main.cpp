@@ -1,9 +1,18 @@
 #include "./Game/Game.h"
 #include <sol/sol.hpp>
 #include <iostream>
+#include <string>
 
 int main(int argc, char *argv[]) {
-    Game game;
+    // Pass --archetypes to store the components in archetype chunks instead of one pool per component
+    StorageMode storageMode = StorageMode::Pools;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--archetypes") {
+            storageMode = StorageMode::Archetypes;
+        }
+    }
+
+    Game game(storageMode);
 
     game.Initialize();
     game.Run();
@@ -0,0 +1,135 @@
+#include "PackedBoxes.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+void PackedBoxes::Clear() {
+    minX.clear();
+    minY.clear();
+    maxX.clear();
+    maxY.clear();
+    layers.clear();
+    masks.clear();
+}
+
+void PackedBoxes::Reserve(std::size_t numSlots) {
+    minX.reserve(numSlots);
+    minY.reserve(numSlots);
+    maxX.reserve(numSlots);
+    maxY.reserve(numSlots);
+    layers.reserve(numSlots);
+    masks.reserve(numSlots);
+}
+
+void PackedBoxes::AlignToBlock() {
+    // Empty slots have no layer, so they never interact with a box
+    while (minX.size() % LANES != 0) {
+        Add(AABB{0.0f, 0.0f, 0.0f, 0.0f}, CollisionFilter{0, 0});
+    }
+}
+
+int PackedBoxes::Add(const AABB &box, const CollisionFilter &filter) {
+    minX.push_back(box.minX);
+    minY.push_back(box.minY);
+    maxX.push_back(box.maxX);
+    maxY.push_back(box.maxY);
+    layers.push_back(filter.layer);
+    masks.push_back(filter.mask);
+    return static_cast<int>(minX.size() - 1);
+}
+
+int PackedBoxes::AppendHits(unsigned bits, int block, int first, int last, int *hits, int numHits) {
+    for (int lane = 0; bits != 0; lane++, bits >>= 1) {
+        const int slot = block + lane;
+        if ((bits & 1u) && slot >= first && slot < last) {
+            hits[numHits++] = slot;
+        }
+    }
+    return numHits;
+}
+
+int PackedBoxes::Overlap(const AABB &box, const CollisionFilter &filter, int first, int last, int *hits) const {
+#if defined(__AVX2__)
+    const __m256i boxLayer = _mm256_set1_epi32(static_cast<int>(filter.layer));
+    const __m256i boxMask = _mm256_set1_epi32(static_cast<int>(filter.mask));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256 boxMinX = _mm256_set1_ps(box.minX);
+    const __m256 boxMinY = _mm256_set1_ps(box.minY);
+    const __m256 boxMaxX = _mm256_set1_ps(box.maxX);
+    const __m256 boxMaxY = _mm256_set1_ps(box.maxY);
+
+    int numHits = 0;
+    for (int block = first - first % LANES; block < last; block += LANES) {
+        const __m256i layerMiss = _mm256_cmpeq_epi32(
+            _mm256_and_si256(_mm256_load_si256(reinterpret_cast<const __m256i *>(&layers[block])), boxMask), zero);
+        const __m256i maskMiss = _mm256_cmpeq_epi32(
+            _mm256_and_si256(_mm256_load_si256(reinterpret_cast<const __m256i *>(&masks[block])), boxLayer), zero);
+        const unsigned interacting =
+            ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(layerMiss, maskMiss)))) & 0xFFu;
+        if (interacting == 0) {
+            continue;
+        }
+
+        __m256 overlap = _mm256_cmp_ps(boxMinX, _mm256_load_ps(&maxX[block]), _CMP_LT_OQ);
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMaxX, _mm256_load_ps(&minX[block]), _CMP_GT_OQ));
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMinY, _mm256_load_ps(&maxY[block]), _CMP_LT_OQ));
+        overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(boxMaxY, _mm256_load_ps(&minY[block]), _CMP_GT_OQ));
+
+        const unsigned bits = interacting & static_cast<unsigned>(_mm256_movemask_ps(overlap));
+        if (bits != 0) {
+            numHits = AppendHits(bits, block, first, last, hits, numHits);
+        }
+    }
+    return numHits;
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i boxLayer = _mm_set1_epi32(static_cast<int>(filter.layer));
+    const __m128i boxMask = _mm_set1_epi32(static_cast<int>(filter.mask));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 boxMinX = _mm_set1_ps(box.minX);
+    const __m128 boxMinY = _mm_set1_ps(box.minY);
+    const __m128 boxMaxX = _mm_set1_ps(box.maxX);
+    const __m128 boxMaxY = _mm_set1_ps(box.maxY);
+
+    int numHits = 0;
+    for (int block = first - first % LANES; block < last; block += LANES) {
+        const __m128i layerMiss = _mm_cmpeq_epi32(
+            _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i *>(&layers[block])), boxMask), zero);
+        const __m128i maskMiss = _mm_cmpeq_epi32(
+            _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i *>(&masks[block])), boxLayer), zero);
+        const unsigned interacting =
+            ~static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(layerMiss, maskMiss)))) & 0xFu;
+        if (interacting == 0) {
+            continue;
+        }
+
+        __m128 overlap = _mm_cmplt_ps(boxMinX, _mm_load_ps(&maxX[block]));
+        overlap = _mm_and_ps(overlap, _mm_cmpgt_ps(boxMaxX, _mm_load_ps(&minX[block])));
+        overlap = _mm_and_ps(overlap, _mm_cmplt_ps(boxMinY, _mm_load_ps(&maxY[block])));
+        overlap = _mm_and_ps(overlap, _mm_cmpgt_ps(boxMaxY, _mm_load_ps(&minY[block])));
+
+        const unsigned bits = interacting & static_cast<unsigned>(_mm_movemask_ps(overlap));
+        if (bits != 0) {
+            numHits = AppendHits(bits, block, first, last, hits, numHits);
+        }
+    }
+    return numHits;
+#else
+    return OverlapScalar(box, filter, first, last, hits);
+#endif
+}
+
+int PackedBoxes::OverlapScalar(const AABB &box, const CollisionFilter &filter, int first, int last, int *hits) const {
+    int numHits = 0;
+    for (int slot = first; slot < last; slot++) {
+        if ((filter.mask & layers[slot]) == 0 || (masks[slot] & filter.layer) == 0) {
+            continue;
+        }
+        if (box.minX < maxX[slot] && box.maxX > minX[slot] && box.minY < maxY[slot] && box.maxY > minY[slot]) {
+            hits[numHits++] = slot;
+        }
+    }
+    return numHits;
+}
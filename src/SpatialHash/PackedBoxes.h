@@ -0,0 +1,122 @@
+#ifndef PACKEDBOXES_H
+#define PACKEDBOXES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+/// @brief Axis-aligned bounding box in world space
+struct AABB {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+};
+
+/// @brief Collision layer of a box and the layers it collides with, two boxes are only tested when both masks
+/// contain the layer of the other box
+struct CollisionFilter {
+    /// @brief Bit of the layer of the box
+    std::uint32_t layer;
+
+    /// @brief Bits of the layers the box collides with
+    std::uint32_t mask;
+};
+
+/// @brief Number of boxes PackedBoxes::Overlap tests at once: 8 with AVX2 (build with -mavx2), 4 with SSE2 and
+/// with the scalar fallback
+#if defined(__AVX2__)
+#define PACKEDBOXES_LANES 8
+#else
+#define PACKEDBOXES_LANES 4
+#endif
+
+/// @brief STL allocator of memory aligned to Alignment bytes, for arrays read with aligned SIMD loads
+template<typename T, std::size_t Alignment>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T *pointer, std::size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment> &) const noexcept { return false; }
+};
+
+/// @brief Boxes and collision filters packed in aligned structure-of-arrays, to test one box against many
+/// Slots are grouped in blocks of LANES. Overlap reads whole blocks with one SIMD load per field, so the
+/// candidates of a query should start a block and the last box must be followed by AlignToBlock: the slots
+/// of the padding never hit.
+class PackedBoxes {
+public:
+    static const int LANES = PACKEDBOXES_LANES;
+
+private:
+    static const std::size_t ALIGNMENT = LANES * sizeof(float);
+
+    template<typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T, ALIGNMENT> >;
+
+    AlignedVector<float> minX;
+    AlignedVector<float> minY;
+    AlignedVector<float> maxX;
+    AlignedVector<float> maxY;
+    AlignedVector<std::uint32_t> layers;
+    AlignedVector<std::uint32_t> masks;
+
+    /// @brief Appends the slots of the set bits of a block hit mask that are inside [first, last)
+    static int AppendHits(unsigned bits, int block, int first, int last, int *hits, int numHits);
+
+public:
+    void Clear();
+
+    void Reserve(std::size_t numSlots);
+
+    /// @brief Gets the number of slots, including the padding
+    int GetSize() const { return static_cast<int>(minX.size()); }
+
+    /// @brief Pads the last block with empty slots, so the next box starts a block
+    void AlignToBlock();
+
+    /// @brief Adds a box
+    /// @return Slot of the box
+    int Add(const AABB &box, const CollisionFilter &filter);
+
+    AABB GetBox(int slot) const { return AABB{minX[slot], minY[slot], maxX[slot], maxY[slot]}; }
+
+    CollisionFilter GetFilter(int slot) const { return CollisionFilter{layers[slot], masks[slot]}; }
+
+    /// @brief Finds the slots whose box overlaps a box and whose layer interacts with it, LANES slots at a time
+    /// with AVX2 or SSE2. The layers of a block are tested first, a block without an interacting layer skips the
+    /// bounds.
+    /// @param first First slot to test, the block that contains it is read whole
+    /// @param last Slot after the last one to test, the block that contains it is read whole
+    /// @param hits Receives the slots that hit in increasing order, room for last - first slots
+    /// @return Number of hits
+    int Overlap(const AABB &box, const CollisionFilter &filter, int first, int last, int *hits) const;
+
+    /// @brief Same as Overlap, one slot at a time
+    int OverlapScalar(const AABB &box, const CollisionFilter &filter, int first, int last, int *hits) const;
+};
+
+#endif /** PACKEDBOXES_H */
@@ -0,0 +1,132 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(float cellSize) : cellSize(DEFAULT_CELL_SIZE) {
+    SetCellSize(cellSize);
+}
+
+void SpatialHash::SetCellSize(float cellSize) {
+    if (cellSize > 0.0f) {
+        this->cellSize = cellSize;
+    }
+}
+
+int SpatialHash::CellCoordinate(float value) const {
+    return static_cast<int>(std::floor(value / cellSize));
+}
+
+std::uint64_t SpatialHash::CellKey(int cellX, int cellY) const {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cellX)) << 32) | static_cast<std::uint32_t>(cellY);
+}
+
+bool SpatialHash::OwnsPair(std::uint64_t cell, const AABB &a, const AABB &b) const {
+    return CellKey(CellCoordinate(std::max(a.minX, b.minX)), CellCoordinate(std::max(a.minY, b.minY))) == cell;
+}
+
+void SpatialHash::Build(const AABB *boxes, int count, const CollisionFilter *filters) {
+    this->boxes.assign(boxes, boxes + count);
+    entries.clear();
+
+    for (int box = 0; box < count; box++) {
+        if (filters && (filters[box].layer == 0 || filters[box].mask == 0)) {
+            continue;
+        }
+
+        const int firstX = CellCoordinate(boxes[box].minX);
+        const int lastX = CellCoordinate(boxes[box].maxX);
+        const int firstY = CellCoordinate(boxes[box].minY);
+        const int lastY = CellCoordinate(boxes[box].maxY);
+        for (int cellX = firstX; cellX <= lastX; cellX++) {
+            for (int cellY = firstY; cellY <= lastY; cellY++) {
+                entries.push_back(CellEntry{CellKey(cellX, cellY), box});
+            }
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const CellEntry &a, const CellEntry &b) {
+        return a.cell != b.cell ? a.cell < b.cell : a.box < b.box;
+    });
+
+    // Pack the boxes of each cell in blocks of their own
+    cells.clear();
+    packedBoxes.Clear();
+    slotBoxes.clear();
+    std::size_t cellBegin = 0;
+    while (cellBegin < entries.size()) {
+        packedBoxes.AlignToBlock();
+        slotBoxes.resize(packedBoxes.GetSize(), -1);
+
+        Cell cell{entries[cellBegin].cell, packedBoxes.GetSize(), 0};
+        std::size_t cellEnd = cellBegin;
+        for (; cellEnd < entries.size() && entries[cellEnd].cell == cell.key; cellEnd++) {
+            const int box = entries[cellEnd].box;
+            packedBoxes.Add(boxes[box], filters ? filters[box] : CollisionFilter{~0u, ~0u});
+            slotBoxes.push_back(box);
+        }
+        cell.last = packedBoxes.GetSize();
+        cells.push_back(cell);
+
+        cellBegin = cellEnd;
+    }
+    packedBoxes.AlignToBlock();
+    slotBoxes.resize(packedBoxes.GetSize(), -1);
+}
+
+void SpatialHash::FindPairs(std::vector<BoxPair> &pairs) const {
+    pairs.clear();
+
+    for (const Cell &cell: cells) {
+        hits.resize(cell.last - cell.first);
+
+        // The slots of a cell are sorted by box, so testing the slots after a box gives a < b in every pair
+        for (int slot = cell.first; slot + 1 < cell.last; slot++) {
+            const AABB a = packedBoxes.GetBox(slot);
+            const int numHits = packedBoxes.Overlap(a, packedBoxes.GetFilter(slot), slot + 1, cell.last, hits.data());
+            for (int hit = 0; hit < numHits; hit++) {
+                if (OwnsPair(cell.key, a, packedBoxes.GetBox(hits[hit]))) {
+                    pairs.emplace_back(slotBoxes[slot], slotBoxes[hits[hit]]);
+                }
+            }
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+}
+
+void SpatialHash::FindOverlaps(const SpatialHash &other, std::vector<BoxPair> &pairs) const {
+    pairs.clear();
+
+    // Both cell lists are sorted by key, walk them together and only test the cells they share
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < cells.size() && j < other.cells.size()) {
+        if (cells[i].key < other.cells[j].key) {
+            i++;
+            continue;
+        }
+        if (other.cells[j].key < cells[i].key) {
+            j++;
+            continue;
+        }
+
+        const Cell &cell = cells[i];
+        const Cell &otherCell = other.cells[j];
+        hits.resize(otherCell.last - otherCell.first);
+        for (int slot = cell.first; slot < cell.last; slot++) {
+            const AABB a = packedBoxes.GetBox(slot);
+            const int numHits = other.packedBoxes.Overlap(a, packedBoxes.GetFilter(slot), otherCell.first,
+                                                          otherCell.last, hits.data());
+            for (int hit = 0; hit < numHits; hit++) {
+                if (OwnsPair(cell.key, a, other.packedBoxes.GetBox(hits[hit]))) {
+                    pairs.emplace_back(slotBoxes[slot], other.slotBoxes[hits[hit]]);
+                }
+            }
+        }
+        i++;
+        j++;
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+}
@@ -0,0 +1,100 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include "PackedBoxes.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// @brief Indices of two boxes that overlap, first < second
+typedef std::pair<int, int> BoxPair;
+
+/// @brief Uniform grid broadphase over a set of boxes
+/// Build inserts every box in each cell it covers, the cells are hashed so the grid has no bounds, and keeps the
+/// entries sorted by cell. FindPairs then only tests boxes that share a cell. A pair that shares several cells
+/// is reported by one of them: the cell of the top-left corner of the intersection, so no pair is repeated.
+/// The boxes of each cell are packed in aligned blocks (see PackedBoxes), so every box of a cell is tested
+/// against the others LANES at a time and boxes whose layers do not interact are skipped before their bounds are
+/// compared.
+class SpatialHash {
+private:
+    /// @brief A box inserted in a cell, the entries are sorted by cell and then by box
+    struct CellEntry {
+        std::uint64_t cell;
+        int box;
+    };
+
+    /// @brief Slots [first, last) of the packed boxes hold the boxes of a cell, first starts a block
+    struct Cell {
+        std::uint64_t key;
+        int first;
+        int last;
+    };
+
+    float cellSize;
+
+    std::vector<CellEntry> entries;
+
+    /// @brief Cells with at least one box, sorted by key
+    std::vector<Cell> cells;
+
+    /// @brief Boxes of each cell, a box that covers several cells is packed once in each of them
+    PackedBoxes packedBoxes;
+
+    /// @brief Box of each packed slot, -1 for the padding [vector index = slot]
+    std::vector<int> slotBoxes;
+
+    /// @brief Slots hit by the box being queried, kept between queries so it stops allocating
+    mutable std::vector<int> hits;
+
+    /// @brief Boxes of the last Build [vector index = box index]
+    std::vector<AABB> boxes;
+
+    /// @brief Checks if a cell is the one that reports the pair of two overlapping boxes
+    bool OwnsPair(std::uint64_t cell, const AABB &a, const AABB &b) const;
+
+    int CellCoordinate(float value) const;
+
+    std::uint64_t CellKey(int cellX, int cellY) const;
+
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 128.0f;
+
+    /// @brief Creates an empty grid
+    /// @param cellSize Width and height of the cells in pixels, around the size of the common boxes
+    explicit SpatialHash(float cellSize = DEFAULT_CELL_SIZE);
+
+    /// @brief Changes the cell size, it is used by the next Build
+    void SetCellSize(float cellSize);
+
+    float GetCellSize() const { return cellSize; }
+
+    /// @brief Replaces the content of the grid
+    /// @param boxes Boxes to insert, their index in the array identifies them in the pairs
+    /// @param count Number of boxes
+    /// @param filters Collision filter of each box, nullptr when every box collides with every other one
+    /// Boxes that collide with no layer are left out of the grid.
+    void Build(const AABB *boxes, int count, const CollisionFilter *filters = nullptr);
+
+    /// @brief Finds every pair of overlapping boxes
+    /// @param pairs Receives the pairs, each one once and sorted, so the order only depends on the boxes
+    void FindPairs(std::vector<BoxPair> &pairs) const;
+
+    /// @brief Finds every box of this grid that overlaps a box of another grid
+    /// @param other Grid with the same cell size, e.g. a grid of static boxes built once
+    /// @param pairs Receives (box of this grid, box of the other grid) pairs, each one once and sorted
+    void FindOverlaps(const SpatialHash &other, std::vector<BoxPair> &pairs) const;
+
+    /// @brief Checks if the layers of two boxes interact
+    static bool Interacts(const CollisionFilter &a, const CollisionFilter &b) {
+        return (a.mask & b.layer) != 0 && (b.mask & a.layer) != 0;
+    }
+
+    /// @brief Checks if two boxes overlap, boxes that only touch do not
+    static bool Overlaps(const AABB &a, const AABB &b) {
+        return a.minX < b.maxX && a.maxX > b.minX && a.minY < b.maxY && a.maxY > b.minY;
+    }
+};
+
+#endif /** SPATIALHASH_H */
@@ -15,18 +15,29 @@ public:
     {
         RequireComponent<SpriteComponent>();
         RequireComponent<AnimationComponent>();
+
+        WriteComponent<SpriteComponent>();
+        WriteComponent<AnimationComponent>();
     }
 
-    void Update()
+    void Update(const std::unique_ptr<Registry> &registry)
     {
-        for (auto entity : GetSystemEntities())
+        const Uint32 ticks = SDL_GetTicks();
+
+        registry->ParallelForEach(*this, 256, [ticks](Entity entity)
         {
-            auto &animation = entity.GetComponent<AnimationComponent>();
-            auto &sprite = entity.GetComponent<SpriteComponent>();
+            const auto &animation = entity.GetComponent<AnimationComponent>();
+            const auto &sprite = entity.GetComponent<SpriteComponent>();
+
+            const int currentFrame = ((ticks - animation.startTime) * animation.frameSpeedRate / 1000) % animation.numFrames;
 
-            animation.currentFrame = ((SDL_GetTicks() - animation.startTime) * animation.frameSpeedRate / 1000) % animation.numFrames;
-            sprite.srcRect.x = animation.currentFrame * sprite.width;
-        }
+            // Only stamp the components when the frame changes, most frames show the same one
+            if (animation.currentFrame != currentFrame || sprite.srcRect.x != currentFrame * sprite.width)
+            {
+                entity.GetMutableComponent<AnimationComponent>().currentFrame = currentFrame;
+                entity.GetMutableComponent<SpriteComponent>().srcRect.x = currentFrame * sprite.width;
+            }
+        });
     }
 };
 
@@ -15,6 +15,9 @@ public:
     CameraMovementSystem() {
         RequireComponent<CameraFollowComponent>();
         RequireComponent<TransformComponent>();
+
+        ReadComponent<CameraFollowComponent>();
+        ReadComponent<TransformComponent>();
     }
 
     void Update(SDL_Rect &camera) {
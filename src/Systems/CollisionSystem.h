@@ -4,74 +4,349 @@
 #include "../ECS/ECS.h"
 #include "../EventBus/EventBus.h"
 #include "../Components/BoxColliderComponent.h"
+#include "../Components/RigidbodyComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../Events/CollisionEvent.h"
+#include "../FrameArena/FrameArena.h"
+#include "../SpatialHash/SpatialHash.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
 
 class CollisionSystem : public System
 {
+private:
+    /// @brief Cached state of the collider of an entity
+    struct Collider
+    {
+        /// @brief Entity the state belongs to, a different entity means the id was reused
+        Entity entity;
+
+        /// @brief World AABB of the collider
+        AABB box = AABB{0, 0, 0, 0};
+
+        /// @brief Layer and mask of the collider
+        int layer = 0;
+        std::uint32_t mask = ALL_COLLISION_LAYERS;
+
+        /// @brief Dynamic colliders are tested every frame, static ones are baked in the static grid
+        bool isDynamic = false;
+    };
+
+    /// @brief Collider state of each entity with a transform and a collider [vector index = entity id]
+    /// Only the entities whose transform, collider or rigidbody changed are recomputed, so writes to them must
+    /// be stamped (GetMutableComponent, or MarkComponentChanged after writing through a view)
+    std::vector<Collider> colliders;
+
+    /// @brief Change tick the colliders were last updated at
+    std::uint32_t collidersTick = 0;
+
+    /// @brief Broadphase of the dynamic colliders, rebuilt every frame
+    SpatialHash dynamicGrid;
+
+    /// @brief Broadphase of the static colliders, only rebuilt when the set of static colliders changes
+    SpatialHash staticGrid;
+
+    /// @brief Static colliders baked in the static grid, sorted by entity id [vector index = box of the grid]
+    std::vector<Entity> staticColliders;
+
+    /// @brief Set when a static collider is added or becomes dynamic
+    bool isStaticGridDirty = true;
+
+    /// @brief Names of the collision layers [vector index = layer]
+    std::vector<std::string> layerNames{"default"};
+
+    /// @brief Layer interaction matrix, bit j of row i is set when layer i collides with layer j (always symmetric)
+    std::uint32_t layerCollisions[MAX_COLLISION_LAYERS];
+
+    /// @brief Layers whose contacts emit a CollisionStayEvent every frame, one bit per layer
+    std::uint32_t stayLayers = 0;
+
+    /// @brief Pairs that overlapped in the last frame, sorted with CompareContacts
+    std::vector<std::pair<Entity, Entity>> contacts;
+
+    /// @brief Overlapping pairs of the current frame, kept between frames so they stop allocating
+    std::vector<BoxPair> dynamicPairs;
+    std::vector<BoxPair> staticPairs;
+
+    /// @brief Updates the cached state of the collider of an entity
+    /// Colliders start static unless the entity has a rigidbody. A static collider whose box moves (e.g. an
+    /// entity moved by its script) becomes dynamic for good, so the static grid is not rebaked every frame.
+    void UpdateCollider(Entity entity)
+    {
+        const TransformComponent transform = entity.GetComponent<TransformComponent>();
+        const auto &boxCollider = entity.GetComponent<BoxColliderComponent>();
+        const float x = transform.position.x + boxCollider.offset.x;
+        const float y = transform.position.y + boxCollider.offset.y;
+        const AABB box = AABB{x, y, x + boxCollider.width, y + boxCollider.height};
+
+        if (static_cast<std::size_t>(entity.GetId()) >= colliders.size())
+        {
+            colliders.resize(entity.GetId() + 1);
+        }
+        Collider &collider = colliders[entity.GetId()];
+        const int layer = boxCollider.layer >= 0 && boxCollider.layer < MAX_COLLISION_LAYERS ? boxCollider.layer : 0;
+
+        if (collider.entity != entity)
+        {
+            collider.entity = entity;
+            collider.isDynamic = entity.HasComponent<RigidbodyComponent>();
+            isStaticGridDirty |= !collider.isDynamic;
+        }
+        else if (!collider.isDynamic)
+        {
+            // A layer or mask change rebakes the static grid, the collider is promoted on its own checks
+            if (layer != collider.layer || boxCollider.mask != collider.mask)
+            {
+                isStaticGridDirty = true;
+            }
+            if (entity.HasComponent<RigidbodyComponent>() || box.minX != collider.box.minX ||
+                box.minY != collider.box.minY || box.maxX != collider.box.maxX || box.maxY != collider.box.maxY)
+            {
+                collider.isDynamic = true;
+                isStaticGridDirty = true;
+            }
+        }
+        collider.box = box;
+        collider.layer = layer;
+        collider.mask = boxCollider.mask;
+    }
+
+    /// @brief Orders contacts by entity ids, the handles only tell apart entities that reused an id
+    static bool CompareContacts(const std::pair<Entity, Entity> &a, const std::pair<Entity, Entity> &b)
+    {
+        if (a.first.GetId() != b.first.GetId())
+        {
+            return a.first.GetId() < b.first.GetId();
+        }
+        if (a.second.GetId() != b.second.GetId())
+        {
+            return a.second.GetId() < b.second.GetId();
+        }
+        return a.first.GetHandle() != b.first.GetHandle() ? a.first.GetHandle() < b.first.GetHandle()
+                                                          : a.second.GetHandle() < b.second.GetHandle();
+    }
+
+    /// @brief Checks if a contact emits stay events, the layer of either collider can ask for them
+    bool ReportsStay(const std::pair<Entity, Entity> &contact) const
+    {
+        const std::uint32_t layers = (1u << colliders[contact.first.GetId()].layer) |
+                                     (1u << colliders[contact.second.GetId()].layer);
+        return (stayLayers & layers) != 0;
+    }
+
+    /// @brief Gets the broadphase filter of a collider from its layer, its mask and the interaction matrix
+    CollisionFilter GetFilter(const Collider &collider) const
+    {
+        return CollisionFilter{1u << collider.layer, layerCollisions[collider.layer] & collider.mask};
+    }
+
 public:
     CollisionSystem()
     {
         RequireComponent<TransformComponent>();
         RequireComponent<BoxColliderComponent>();
+
+        // Until a level sets the interactions every layer collides with every other one
+        std::fill(std::begin(layerCollisions), std::end(layerCollisions), ALL_COLLISION_LAYERS);
+    }
+
+    /// @brief Gets the layer with a name, the layer is added the first time its name is used
+    /// @return Layer index, or the default layer 0 when all MAX_COLLISION_LAYERS layers are in use
+    int GetLayer(const std::string &name)
+    {
+        auto it = std::find(layerNames.begin(), layerNames.end(), name);
+        if (it != layerNames.end())
+        {
+            return static_cast<int>(it - layerNames.begin());
+        }
+        if (layerNames.size() == MAX_COLLISION_LAYERS)
+        {
+            Logger::Err("Collision layer " + name + " ignored, there are already " +
+                        std::to_string(MAX_COLLISION_LAYERS) + " layers");
+            return 0;
+        }
+        layerNames.push_back(name);
+        return static_cast<int>(layerNames.size() - 1);
     }
 
-    void Update(std::unique_ptr<EventBus> &eventBus)
+    /// @brief Removes every layer interaction, so no pair is reported until SetLayersCollide adds them back
+    void ClearLayerCollisions()
     {
-        auto entities = GetSystemEntities();
+        std::fill(std::begin(layerCollisions), std::end(layerCollisions), 0u);
+        isStaticGridDirty = true;
+    }
 
-        // Loop all the entities that the system is interested in
-        for (auto i = entities.begin(); i != entities.end(); i++)
+    /// @brief Sets if two layers collide with each other, pairs of layers that do not are never tested
+    void SetLayersCollide(int layerA, int layerB, bool collide = true)
+    {
+        if (collide)
         {
-            Entity a = *i;
-            auto aTransform = a.GetComponent<TransformComponent>();
-            auto aCollider = a.GetComponent<BoxColliderComponent>();
+            layerCollisions[layerA] |= 1u << layerB;
+            layerCollisions[layerB] |= 1u << layerA;
+        }
+        else
+        {
+            layerCollisions[layerA] &= ~(1u << layerB);
+            layerCollisions[layerB] &= ~(1u << layerA);
+        }
+        isStaticGridDirty = true;
+    }
+
+    /// @brief Sets if the contacts of a layer emit a CollisionStayEvent every frame they last
+    void SetLayerReportsStay(int layer, bool reportsStay = true)
+    {
+        if (reportsStay)
+        {
+            stayLayers |= 1u << layer;
+        }
+        else
+        {
+            stayLayers &= ~(1u << layer);
+        }
+    }
+
+    /// @brief Checks if two layers collide with each other
+    bool LayersCollide(int layerA, int layerB) const
+    {
+        return (layerCollisions[layerA] >> layerB) & 1u;
+    }
+
+    /// @brief Sets the size of the broadphase cells, e.g. from the collision table of the level
+    void SetCellSize(float cellSize)
+    {
+        dynamicGrid.SetCellSize(cellSize);
+        staticGrid.SetCellSize(cellSize);
+        isStaticGridDirty = true;
+    }
 
-            // Loop all the entities that still need to be checked (to the right of i)
-            for (auto j = i; j != entities.end(); j++)
+    void Update(const std::unique_ptr<Registry> &registry, std::unique_ptr<EventBus> &eventBus, FrameArena &frameArena)
+    {
+        // Entities that are not in the system yet are updated too, they may join it in the next Registry::Update
+        for (auto entity : registry->GetEntitiesChangedSince<TransformComponent, BoxColliderComponent, RigidbodyComponent>(collidersTick))
+        {
+            if (entity.HasComponent<TransformComponent>() && entity.HasComponent<BoxColliderComponent>())
             {
-                Entity b = *j;
+                UpdateCollider(entity);
+            }
+        }
+        collidersTick = registry->AdvanceChangeTick();
+
+        // Split the system entities sorted by entity id, so the pairs come out in the same order every time the
+        // same entities collide
+        std::vector<Entity, FrameAllocator<Entity>> entities{FrameAllocator<Entity>(frameArena)};
+        entities.assign(GetSystemEntities().begin(), GetSystemEntities().end());
+        std::sort(entities.begin(), entities.end(),
+                  [](Entity a, Entity b) { return a.GetId() < b.GetId(); });
 
-                // Bypass if we are trying to test same entity
-                if (a == b)
+        std::vector<Entity, FrameAllocator<Entity>> dynamicColliders{FrameAllocator<Entity>(frameArena)};
+        std::vector<AABB, FrameAllocator<AABB>> dynamicBoxes{FrameAllocator<AABB>(frameArena)};
+        std::vector<CollisionFilter, FrameAllocator<CollisionFilter>> dynamicFilters{
+            FrameAllocator<CollisionFilter>(frameArena)};
+        std::size_t numStaticColliders = 0;
+        for (auto entity : entities)
+        {
+            if (static_cast<std::size_t>(entity.GetId()) >= colliders.size() || colliders[entity.GetId()].entity != entity)
+            {
+                UpdateCollider(entity);
+            }
+            const Collider &collider = colliders[entity.GetId()];
+            if (collider.isDynamic)
+            {
+                dynamicColliders.push_back(entity);
+                dynamicBoxes.push_back(collider.box);
+                dynamicFilters.push_back(GetFilter(collider));
+            }
+            else
+            {
+                numStaticColliders++;
+            }
+        }
+
+        // A static collider that was removed or killed changes the count, one that was added marks the grid dirty
+        if (isStaticGridDirty || numStaticColliders != staticColliders.size())
+        {
+            staticColliders.clear();
+            std::vector<AABB, FrameAllocator<AABB>> staticBoxes{FrameAllocator<AABB>(frameArena)};
+            staticBoxes.reserve(numStaticColliders);
+            std::vector<CollisionFilter, FrameAllocator<CollisionFilter>> staticFilters{
+                FrameAllocator<CollisionFilter>(frameArena)};
+            staticFilters.reserve(numStaticColliders);
+            for (auto entity : entities)
+            {
+                const Collider &collider = colliders[entity.GetId()];
+                if (!collider.isDynamic)
                 {
-                    continue;
+                    staticColliders.push_back(entity);
+                    staticBoxes.push_back(collider.box);
+                    staticFilters.push_back(GetFilter(collider));
                 }
+            }
+            staticGrid.Build(staticBoxes.data(), static_cast<int>(staticBoxes.size()), staticFilters.data());
+            isStaticGridDirty = false;
 
-                auto bTransform = b.GetComponent<TransformComponent>();
-                auto bCollider = b.GetComponent<BoxColliderComponent>();
-
-                // Perform the AABB collision check between entities a and b
-                bool collisionHappened = CheckAABBCollision(
-                    aTransform.position.x + aCollider.offset.x,
-                    aTransform.position.y + aCollider.offset.y,
-                    aCollider.width,
-                    aCollider.height,
-                    bTransform.position.x + bCollider.offset.x,
-                    bTransform.position.y + bCollider.offset.y,
-                    bCollider.width,
-                    bCollider.height);
-
-                if (collisionHappened)
-                {
-                    Logger::Log("Entity " + std::to_string(a.GetId()) + " is colliding with entity " + std::to_string(b.GetId()));
+            Logger::Log("Baked " + std::to_string(staticColliders.size()) + " static colliders");
+        }
 
-                    eventBus->EmitEvent<CollisionEvent>(a, b);
-                }
+        // Only dynamic colliders are queried, static ones never test each other, and only the pairs of layers that
+        // interact are tested
+        dynamicGrid.Build(dynamicBoxes.data(), static_cast<int>(dynamicBoxes.size()), dynamicFilters.data());
+        dynamicGrid.FindPairs(dynamicPairs);
+        dynamicGrid.FindOverlaps(staticGrid, staticPairs);
+
+        std::vector<std::pair<Entity, Entity>, FrameAllocator<std::pair<Entity, Entity>>> collisions{
+            FrameAllocator<std::pair<Entity, Entity>>(frameArena)};
+        collisions.reserve(dynamicPairs.size() + staticPairs.size());
+        for (const auto &pair : dynamicPairs)
+        {
+            collisions.emplace_back(dynamicColliders[pair.first], dynamicColliders[pair.second]);
+        }
+        for (const auto &pair : staticPairs)
+        {
+            Entity a = dynamicColliders[pair.first];
+            Entity b = staticColliders[pair.second];
+            if (b.GetId() < a.GetId())
+            {
+                std::swap(a, b);
             }
+            collisions.emplace_back(a, b);
         }
-    }
+        std::sort(collisions.begin(), collisions.end(), CompareContacts);
 
-    bool CheckAABBCollision(
-        double aX, double aY, double aW, double aH,
-        double bX, double bY, double bW, double bH)
-    {
-        return (
-            aX < bX + bW &&
-            aX + aW > bX &&
-            aY < bY + bH &&
-            aY + aH > bY);
+        // Both lists are sorted the same way, walk them together to find the contacts that started, lasted or ended
+        std::size_t current = 0;
+        std::size_t previous = 0;
+        while (current < collisions.size() || previous < contacts.size())
+        {
+            if (previous == contacts.size() ||
+                (current < collisions.size() && CompareContacts(collisions[current], contacts[previous])))
+            {
+                eventBus->EmitEvent<CollisionEnterEvent>(collisions[current].first, collisions[current].second);
+                current++;
+            }
+            else if (current == collisions.size() || CompareContacts(contacts[previous], collisions[current]))
+            {
+                // Handlers can not use the components of a killed entity
+                const std::pair<Entity, Entity> &contact = contacts[previous];
+                if (contact.first.IsAlive() && contact.second.IsAlive())
+                {
+                    eventBus->EmitEvent<CollisionExitEvent>(contact.first, contact.second);
+                }
+                previous++;
+            }
+            else
+            {
+                if (ReportsStay(collisions[current]))
+                {
+                    eventBus->EmitEvent<CollisionStayEvent>(collisions[current].first, collisions[current].second);
+                }
+                current++;
+                previous++;
+            }
+        }
+        contacts.assign(collisions.begin(), collisions.end());
     }
 };
 
-#endif /// COLLISIONSYSTEM_H
\ No newline at end of file
+#endif /// COLLISIONSYSTEM_H
@@ -9,33 +9,41 @@
 #include "../EventBus/EventBus.h"
 
 class DamageSystem : public System {
+private:
+    TagId playerTag;
+    GroupId projectilesGroup;
+    GroupId enemiesGroup;
+
 public:
     DamageSystem() {
         RequireComponent<BoxColliderComponent>();
+
+        playerTag = Entity::registry->GetTagId("player");
+        projectilesGroup = Entity::registry->GetGroupId("projectiles");
+        enemiesGroup = Entity::registry->GetGroupId("enemies");
     }
 
     void SubscribeToEvents(std::unique_ptr<EventBus> &eventBus) {
-        eventBus->SubscribeToEvent<CollisionEvent>(this, &DamageSystem::OnCollision);
+        eventBus->SubscribeToEvent<CollisionEnterEvent>(this, &DamageSystem::OnCollision);
     }
 
-    void OnCollision(CollisionEvent &event) {
+    void OnCollision(CollisionEnterEvent &event) {
         Entity a = event.a;
         Entity b = event.b;
-        Logger::Log("Collision Event emitted: " + std::to_string(a.GetId()) + " and " + std::to_string(b.GetId()));
 
-        if (a.BelongsToGroup("projectiles") && b.HasTag("player")) {
+        if (a.BelongsToGroup(projectilesGroup) && b.HasTag(playerTag)) {
             OnProjectileHitsPlayer(a, b);
         }
 
-        if (b.BelongsToGroup("projectiles") && a.HasTag("player")) {
+        if (b.BelongsToGroup(projectilesGroup) && a.HasTag(playerTag)) {
             OnProjectileHitsPlayer(b, a);
         }
 
-        if (a.BelongsToGroup("projectiles") && b.BelongsToGroup("enemies")) {
+        if (a.BelongsToGroup(projectilesGroup) && b.BelongsToGroup(enemiesGroup)) {
             OnProjectileHitsEnemy(a, b);
         }
 
-        if (b.BelongsToGroup("projectiles") && a.BelongsToGroup("enemies")) {
+        if (b.BelongsToGroup(projectilesGroup) && a.BelongsToGroup(enemiesGroup)) {
             OnProjectileHitsEnemy(b, a);
         }
     }
@@ -44,7 +52,7 @@ public:
         auto projectileComponent = projectile.GetComponent<ProjectileComponent>();
 
         if (!projectileComponent.isFriendly) {
-            auto &healthComponent = player.GetComponent<HealthComponent>();
+            auto &&healthComponent = player.GetMutableComponent<HealthComponent>();
             healthComponent.healthPercentage -= projectileComponent.hitPercentDamage;
 
             if (healthComponent.healthPercentage <= 0) {
@@ -58,7 +66,7 @@ public:
     void OnProjectileHitsEnemy(Entity projectile, Entity enemy) {
         auto projectileComponent = projectile.GetComponent<ProjectileComponent>();
         if (projectileComponent.isFriendly) {
-            auto &healthComponent = enemy.GetComponent<HealthComponent>();
+            auto &&healthComponent = enemy.GetMutableComponent<HealthComponent>();
             healthComponent.healthPercentage -= projectileComponent.hitPercentDamage;
 
             if (healthComponent.healthPercentage <= 0) {
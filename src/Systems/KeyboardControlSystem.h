@@ -28,8 +28,8 @@ public:
         for (auto entity : GetSystemEntities())
         {
             const auto keyboardControl = entity.GetComponent<KeyboardControlledComponent>();
-            auto &sprite = entity.GetComponent<SpriteComponent>();
-            auto &rigidbody = entity.GetComponent<RigidbodyComponent>();
+            auto &&sprite = entity.GetMutableComponent<SpriteComponent>();
+            auto &&rigidbody = entity.GetMutableComponent<RigidbodyComponent>();
 
             switch (event.symbol)
             {
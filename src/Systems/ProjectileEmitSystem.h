@@ -14,14 +14,90 @@
 #include "../Components/ProjectileEmitterComponent.h"
 #include "../Components/ProjectileComponent.h"
 #include "../Components/CameraFollowComponent.h"
+#include "CollisionSystem.h"
 
 #include "SDL2/SDL.h"
 
 class ProjectileEmitSystem : public System {
+private:
+    GroupId projectilesGroup;
+
+    /// @brief Collision layers of the projectiles shot by the player and by the enemies, resolved on the first
+    /// emission so they do not depend on the order the systems are added in
+    int playerProjectilesLayer = 0;
+    int enemyProjectilesLayer = 0;
+    bool areLayersResolved = false;
+
+    /// @brief Components shared by every projectile, each shot only sets its position, velocity, damage and layer
+    Prefab projectilePrefab;
+
+    /// @brief Projectile waiting to be instantiated with the other shots of the frame
+    struct ProjectileShot {
+        glm::vec2 position;
+        glm::vec2 velocity;
+        ProjectileComponent projectile;
+    };
+
+    std::vector<ProjectileShot> pendingShots;
+
+    void ResolveLayers() {
+        if (Entity::registry->HasSystem<CollisionSystem>()) {
+            auto &collisionSystem = Entity::registry->GetSystem<CollisionSystem>();
+            playerProjectilesLayer = collisionSystem.GetLayer("player_projectiles");
+            enemyProjectilesLayer = collisionSystem.GetLayer("enemy_projectiles");
+        } else {
+            Logger::Err("Projectiles are emitted on the default collision layer, there is no CollisionSystem");
+        }
+        areLayersResolved = true;
+    }
+
+    void EmitProjectile(glm::vec2 position, glm::vec2 velocity, const ProjectileEmitterComponent &projectileEmitter) {
+        pendingShots.push_back(ProjectileShot{position, velocity,
+                                              ProjectileComponent(projectileEmitter.isFriendly,
+                                                                  projectileEmitter.hitPercentDamage,
+                                                                  projectileEmitter.projectileDuration)});
+    }
+
+    /// @brief Instantiates the pending shots in one batch, then sets the values of each projectile
+    /// @details The system declares no component access, so it runs outside the jobs and the copies can be
+    /// modified right after Instantiate
+    void InstantiatePendingShots() {
+        if (pendingShots.empty()) {
+            return;
+        }
+        if (!areLayersResolved) {
+            ResolveLayers();
+        }
+
+        const auto projectiles = Entity::registry->Instantiate(projectilePrefab, static_cast<int>(pendingShots.size()));
+        for (std::size_t i = 0; i < projectiles.size(); i++) {
+            const ProjectileShot &shot = pendingShots[i];
+            Entity projectile = projectiles[i];
+
+            auto &&transform = projectile.GetMutableComponent<TransformComponent>();
+            transform.position = shot.position;
+            auto &&rigidbody = projectile.GetMutableComponent<RigidbodyComponent>();
+            rigidbody.velocity = shot.velocity;
+            projectile.GetMutableComponent<ProjectileComponent>() = shot.projectile;
+            projectile.GetMutableComponent<BoxColliderComponent>().layer =
+                    shot.projectile.isFriendly ? playerProjectilesLayer : enemyProjectilesLayer;
+        }
+        pendingShots.clear();
+    }
+
 public:
     ProjectileEmitSystem() {
         RequireComponent<ProjectileEmitterComponent>();
         RequireComponent<TransformComponent>();
+
+        projectilesGroup = Entity::registry->GetGroupId("projectiles");
+
+        projectilePrefab.Group(projectilesGroup);
+        projectilePrefab.AddComponent<TransformComponent>(glm::vec2(0.0, 0.0), glm::vec2(1.0, 1.0), 0.0);
+        projectilePrefab.AddComponent<RigidbodyComponent>();
+        projectilePrefab.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
+        projectilePrefab.AddComponent<BoxColliderComponent>(4, 4);
+        projectilePrefab.AddComponent<ProjectileComponent>();
     }
 
     void SubscribeToEvents(std::unique_ptr<EventBus> &eventBus) {
@@ -34,8 +110,8 @@ public:
             for (auto entity: GetSystemEntities()) {
                 if (entity.HasComponent<CameraFollowComponent>()) {
                     const auto projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
-                    const auto transform = entity.GetComponent<TransformComponent>();
-                    const auto rigidbody = entity.GetComponent<RigidbodyComponent>();
+                    const TransformComponent transform = entity.GetComponent<TransformComponent>();
+                    const RigidbodyComponent rigidbody = entity.GetComponent<RigidbodyComponent>();
 
                     glm::vec2 projectilePosition = transform.position;
                     if (entity.HasComponent<SpriteComponent>()) {
@@ -54,24 +130,17 @@ public:
                     projectileVelocity.x = projectileEmitter.projectileVelocity.x * directionX;
                     projectileVelocity.y = projectileEmitter.projectileVelocity.y * directionY;
 
-                    Entity projectile = entity.registry->CreateEntity();
-                    projectile.Group("projectiles");
-                    projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-                    projectile.AddComponent<RigidbodyComponent>(projectileVelocity);
-                    projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-                    projectile.AddComponent<BoxColliderComponent>(4, 4);
-                    projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly,
-                                                                 projectileEmitter.hitPercentDamage,
-                                                                 projectileEmitter.projectileDuration);
+                    EmitProjectile(projectilePosition, projectileVelocity, projectileEmitter);
                 }
             }
+            InstantiatePendingShots();
         }
     }
 
     void Update(std::unique_ptr<Registry> &registry) {
         for (auto entity: GetSystemEntities()) {
-            auto &projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
-            const auto transform = entity.GetComponent<TransformComponent>();
+            const auto &projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
+            const TransformComponent transform = entity.GetComponent<TransformComponent>();
 
             if (projectileEmitter.repeatFrequency == 0) {
                 continue;
@@ -87,21 +156,13 @@ public:
                     projectilePosition.y += (transform.scale.y * sprite.height / 2);
                 }
 
-                // registry->CreateEntity()...
-                Entity projectile = registry->CreateEntity();
-                projectile.Group("projectiles");
-                projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-                projectile.AddComponent<RigidbodyComponent>(projectileEmitter.projectileVelocity);
-                projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-                projectile.AddComponent<BoxColliderComponent>(4, 4);
-                projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly,
-                                                             projectileEmitter.hitPercentDamage,
-                                                             projectileEmitter.projectileDuration);
+                EmitProjectile(projectilePosition, projectileEmitter.projectileVelocity, projectileEmitter);
 
                 // Update the projectile emitter component last emission to the current milliseconds
-                projectileEmitter.lastEmissionTime = SDL_GetTicks();
+                entity.GetMutableComponent<ProjectileEmitterComponent>().lastEmissionTime = SDL_GetTicks();
             }
         }
+        InstantiatePendingShots();
     }
 };
 
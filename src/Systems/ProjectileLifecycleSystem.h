@@ -12,6 +12,8 @@ class ProjectileLifecycleSystem : public System {
 public:
     ProjectileLifecycleSystem() {
         RequireComponent<ProjectileComponent>();
+
+        ReadComponent<ProjectileComponent>();
     }
 
     void Update() {
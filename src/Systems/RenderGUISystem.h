@@ -16,6 +16,7 @@
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
 #include "../Components/HealthComponent.h"
+#include "CollisionSystem.h"
 
 class RenderGUISystem : public System {
 public:
@@ -35,6 +36,7 @@ public:
             static float rbVelX = 0.0f;
             static float rbVelY = 0.0f;
             static int enemyHealth = 100;
+            static int enemyCount = 1;
 
             // Sprites
             const char *sprites[] = {"tank-image", "truck-image", "radar-image", "chopper-image"};
@@ -104,9 +106,11 @@ public:
             ImGui::Spacing();
 
             // --- LÓGICA DE SPAWN ---
+            ImGui::SliderInt("Count", &enemyCount, 1, 1000);
             if (ImGui::Button("Spawn new enemy")) {
-                Entity enemy = registry->CreateEntity();
-                enemy.Group("enemies");
+                // Every copy shares the values of the form, so they are created in one batch from a prefab
+                Prefab enemy;
+                enemy.Group(registry->GetGroupId("enemies"));
 
                 enemy.AddComponent<TransformComponent>(
                     glm::vec2(enemyXPos, enemyYPos),
@@ -125,9 +129,14 @@ public:
                     spriteZIndex
                 );
 
+                const int enemiesLayer = registry->HasSystem<CollisionSystem>()
+                                             ? registry->GetSystem<CollisionSystem>().GetLayer("enemies")
+                                             : 0;
                 enemy.AddComponent<BoxColliderComponent>(
                     colliderWidth,
-                    colliderHeight
+                    colliderHeight,
+                    glm::vec2(0),
+                    enemiesLayer
                 );
 
                 // Conversão de Graus para Vetor
@@ -146,6 +155,62 @@ public:
                 );
 
                 enemy.AddComponent<HealthComponent>(enemyHealth);
+
+                registry->Instantiate(enemy, enemyCount);
+            }
+        }
+        ImGui::End();
+
+        // Memory and occupancy of the registry, e.g. to check what a level still holds after a wave dies
+        if (ImGui::Begin("Registry stats")) {
+            const RegistryStats stats = registry->GetStats();
+            ImGui::Text("Entities: %d live, %d free ids, %d ids used", stats.numLiveEntities, stats.numFreeIds,
+                        stats.numEntities);
+            if (stats.numArchetypes > 0) {
+                ImGui::Text("Archetypes: %d in %d chunks (%.1f KB)", stats.numArchetypes, stats.numChunks,
+                            stats.chunkBytes / 1024.0);
+            }
+
+            if (ImGui::CollapsingHeader("Pools", ImGuiTreeNodeFlags_DefaultOpen)) {
+                ImGui::Columns(6, "pools");
+                ImGui::Text("Component");
+                ImGui::NextColumn();
+                ImGui::Text("Live / peak");
+                ImGui::NextColumn();
+                ImGui::Text("Capacity");
+                ImGui::NextColumn();
+                ImGui::Text("KB used / reserved");
+                ImGui::NextColumn();
+                ImGui::Text("Growths");
+                ImGui::NextColumn();
+                ImGui::Text("Fragmentation");
+                ImGui::NextColumn();
+                ImGui::Separator();
+                for (const auto &pool: stats.pools) {
+                    ImGui::Text("%s", pool.componentName.c_str());
+                    ImGui::NextColumn();
+                    ImGui::Text("%d / %d", pool.size, pool.peakSize);
+                    ImGui::NextColumn();
+                    ImGui::Text("%d", pool.capacity);
+                    ImGui::NextColumn();
+                    ImGui::Text("%.1f / %.1f", pool.bytesUsed / 1024.0, pool.bytesReserved / 1024.0);
+                    ImGui::NextColumn();
+                    ImGui::Text("%d", pool.numGrowths);
+                    ImGui::NextColumn();
+                    ImGui::Text("%.0f%%", pool.fragmentation * 100.0);
+                    ImGui::NextColumn();
+                }
+                ImGui::Columns(1);
+            }
+
+            if (ImGui::CollapsingHeader("Systems")) {
+                for (const auto &system: stats.systems) {
+                    ImGui::Text("%s: %d entities", system.systemName.c_str(), system.numEntities);
+                }
+            }
+
+            if (ImGui::Button("Dump to JSON")) {
+                registry->DumpStatsToJson("registry-stats.json");
             }
         }
         ImGui::End();
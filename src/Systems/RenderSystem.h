@@ -5,63 +5,87 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../AssetStore/AssetStore.h"
+#include "../FrameArena/FrameArena.h"
 
 #include <SDL2/SDL.h>
 #include <memory>
 #include <algorithm>
 
 class RenderSystem : public System {
+private:
+    /// @brief Change tick the sprite pool was last sorted at
+    std::uint32_t spritesSortTick = 0;
+
 public:
     RenderSystem() {
         RequireComponent<TransformComponent>();
         RequireComponent<SpriteComponent>();
     }
 
-    void Update(SDL_Renderer *renderer, std::unique_ptr<AssetStore> &assetStore, SDL_Rect &camera) {
-        // Todo: Sort all entities of our system by z-index
-
+    void Update(const std::unique_ptr<Registry> &registry, SDL_Renderer *renderer,
+                std::unique_ptr<AssetStore> &assetStore, SDL_Rect &camera, FrameArena &frameArena) {
+        // The sprite is not copied (it owns the asset id string), nothing adds sprites while rendering
         struct RenderableEntity {
             TransformComponent transformComponent;
-            SpriteComponent spriteComponent;
+            const SpriteComponent *spriteComponent;
         };
 
-        std::vector<RenderableEntity> renderableEntities;
-
-        for (auto entity: GetSystemEntities()) {
-            RenderableEntity renderableEntity;
-            renderableEntity.transformComponent = entity.GetComponent<TransformComponent>();
-            renderableEntity.spriteComponent = entity.GetComponent<SpriteComponent>();
+        // Rebuilt every frame, so it lives in the frame arena
+        std::vector<RenderableEntity, FrameAllocator<RenderableEntity> > renderableEntities{
+            FrameAllocator<RenderableEntity>(frameArena)};
+        renderableEntities.reserve(GetSystemEntities().size());
 
+        auto addIfVisible = [&](const TransformComponent &transform, const SpriteComponent &sprite) {
             // Check if the entity sprite is outside the camera view
             bool isOutsideCameraView = (
-                renderableEntity.transformComponent.position.x + (
-                    renderableEntity.transformComponent.scale.x * renderableEntity.spriteComponent.width) < camera.x ||
-                renderableEntity.transformComponent.position.x > camera.x + camera.w ||
-                renderableEntity.transformComponent.position.y + (
-                    renderableEntity.transformComponent.scale.y * renderableEntity.spriteComponent.height) < camera.y ||
-                renderableEntity.transformComponent.position.y > camera.y + camera.h
+                transform.position.x + (transform.scale.x * sprite.width) < camera.x ||
+                transform.position.x > camera.x + camera.w ||
+                transform.position.y + (transform.scale.y * sprite.height) < camera.y ||
+                transform.position.y > camera.y + camera.h
             );
 
             // Cull sprites that are outside the camera view (and are not fixed)
-            if (isOutsideCameraView && !renderableEntity.spriteComponent.isFixed) {
-                continue;
+            if (isOutsideCameraView && !sprite.isFixed) {
+                return;
             }
 
-            renderableEntities.emplace_back(renderableEntity);
+            renderableEntities.push_back(RenderableEntity{transform, &sprite});
+        };
+
+        auto *spritePool = registry->GetComponentPool<SpriteComponent>();
+        auto *transformPool = registry->GetComponentPool<TransformComponent>();
+        if (spritePool && transformPool) {
+            // Pool mode: keep the sprite pool sorted by z-index and walk it in that order. The pool is only
+            // reordered when a sprite was added or removed or a changed sprite ended up out of order, so zIndex
+            // writes must be stamped (GetMutableComponent or MarkComponentChanged).
+            spritePool->Sort([](const SpriteComponent &a, const SpriteComponent &b) { return a.zIndex < b.zIndex; },
+                             spritesSortTick);
+            spritesSortTick = registry->AdvanceChangeTick();
+
+            for (int i = 0; i < spritePool->GetSize(); i++) {
+                const int entityId = spritePool->GetEntityId(i);
+                if (transformPool->Contains(entityId)) {
+                    addIfVisible(transformPool->Get(entityId), (*spritePool)[i]);
+                }
+            }
+        } else {
+            // Archetype mode: sort the visible sprites of every frame
+            registry->View<TransformComponent, SpriteComponent>().Each(
+                [&](Entity, const TransformComponent &transform, const SpriteComponent &sprite) {
+                    addIfVisible(transform, sprite);
+                });
+
+            std::stable_sort(
+                renderableEntities.begin(),
+                renderableEntities.end(),
+                [](const RenderableEntity &a, const RenderableEntity &b) {
+                    return a.spriteComponent->zIndex < b.spriteComponent->zIndex;
+                });
         }
 
-        std::sort(
-            renderableEntities.begin(),
-            renderableEntities.end(),
-            [](
-        const RenderableEntity &a,
-        const RenderableEntity &b) {
-                return a.spriteComponent.zIndex < b.spriteComponent.zIndex;
-            });
-
-        for (auto entity: renderableEntities) {
-            const auto transform = entity.transformComponent;
-            const auto sprite = entity.spriteComponent;
+        for (const auto &entity: renderableEntities) {
+            const auto &transform = entity.transformComponent;
+            const auto &sprite = *entity.spriteComponent;
 
             // Set the source rectangle of our original sprite texture
             SDL_Rect srcRect = sprite.srcRect;
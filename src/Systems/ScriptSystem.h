@@ -31,7 +31,7 @@ std::tuple<double, double> GetEntityVelocity(Entity entity) {
 
 void SetEntityPosition(Entity entity, double x, double y) {
     if (entity.HasComponent<TransformComponent>()) {
-        auto& transform = entity.GetComponent<TransformComponent>();
+        auto&& transform = entity.GetMutableComponent<TransformComponent>();
         transform.position.x = x;
         transform.position.y = y;
     } else {
@@ -41,7 +41,7 @@ void SetEntityPosition(Entity entity, double x, double y) {
 
 void SetEntityVelocity(Entity entity, double x, double y) {
     if (entity.HasComponent<RigidbodyComponent>()) {
-        auto& rigidbody = entity.GetComponent<RigidbodyComponent>();
+        auto&& rigidbody = entity.GetMutableComponent<RigidbodyComponent>();
         rigidbody.velocity.x = x;
         rigidbody.velocity.y = y;
     } else {
@@ -51,7 +51,7 @@ void SetEntityVelocity(Entity entity, double x, double y) {
 
 void SetEntityRotation(Entity entity, double angle) {
     if (entity.HasComponent<TransformComponent>()) {
-        auto& transform = entity.GetComponent<TransformComponent>();
+        auto&& transform = entity.GetMutableComponent<TransformComponent>();
         transform.rotation = angle;
     } else {
         Logger::Err("Trying to set the rotation of an entity that has no transform component");
@@ -60,7 +60,7 @@ void SetEntityRotation(Entity entity, double angle) {
 
 void SetEntityAnimationFrame(Entity entity, int frame) {
     if (entity.HasComponent<AnimationComponent>()) {
-        auto& animation = entity.GetComponent<AnimationComponent>();
+        auto&& animation = entity.GetMutableComponent<AnimationComponent>();
         animation.currentFrame = frame;
     } else {
         Logger::Err("Trying to set the animation frame of an entity that has no animation component");
@@ -69,7 +69,7 @@ void SetEntityAnimationFrame(Entity entity, int frame) {
 
 void SetProjectileVelocity(Entity entity, double x, double y) {
     if (entity.HasComponent<ProjectileEmitterComponent>()) {
-        auto& projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
+        auto&& projectileEmitter = entity.GetMutableComponent<ProjectileEmitterComponent>();
         projectileEmitter.projectileVelocity.x = x;
         projectileEmitter.projectileVelocity.y = y;
     } else {
@@ -83,16 +83,39 @@ class ScriptSystem: public System {
             RequireComponent<ScriptComponent>();
         }
 
-        void CreateLuaBindings(sol::state& lua) {
+        void CreateLuaBindings(sol::state& lua, const std::unique_ptr<Registry>& registry) {
             // Create the "entity" usertype so Lua knows what an entity is
+            // Tags and groups can be passed by name or by the id returned from get_tag_id/get_group_id
             lua.new_usertype<Entity>(
                 "entity",
                 "get_id", &Entity::GetId,
+                "is_alive", &Entity::IsAlive,
                 "destroy", &Entity::Kill,
-                "has_tag", &Entity::HasTag,
-                "belongs_to_group", &Entity::BelongsToGroup
+                "has_tag", sol::overload(
+                    static_cast<bool (Entity::*)(TagId) const>(&Entity::HasTag),
+                    static_cast<bool (Entity::*)(const std::string &) const>(&Entity::HasTag)
+                ),
+                "belongs_to_group", sol::overload(
+                    static_cast<bool (Entity::*)(GroupId) const>(&Entity::BelongsToGroup),
+                    static_cast<bool (Entity::*)(const std::string &) const>(&Entity::BelongsToGroup)
+                )
             );
 
+            // Interned tag/group ids, scripts should look them up once instead of passing names every frame
+            lua.set_function("get_tag_id", [&registry](const std::string& tag) { return registry->GetTagId(tag); });
+            lua.set_function("get_group_id", [&registry](const std::string& group) { return registry->GetGroupId(group); });
+
+            // Copies of a prefab declared in the level, created in one batch: spawn_many("bullet", 100)
+            // Returns a table with the new entities
+            lua.set_function("spawn_many", [&registry](const std::string& prefabName, int count) {
+                const Prefab* prefab = registry->GetPrefab(prefabName);
+                if (!prefab) {
+                    Logger::Err("Trying to spawn the unknown prefab '" + prefabName + "'");
+                    return sol::as_table(std::vector<Entity>());
+                }
+                return sol::as_table(registry->Instantiate(*prefab, count));
+            });
+
             // Create all the bindings between C++ and Lua functions
             lua.set_function("get_position", GetEntityPosition);
             lua.set_function("get_velocity", GetEntityVelocity);